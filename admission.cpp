@@ -0,0 +1,104 @@
+#include "admission.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+#include "chunked.h"
+
+
+std::size_t estimate_footprint(const std::size_t population_size, const std::size_t length,
+                               const double mutation_chance, const bool chunked) {
+
+    // Every individual has an error, and the elite and the starting individual are kept as strings.
+    const std::size_t shared = population_size * sizeof(long) + 2 * length;
+
+    if (!chunked) {
+        return shared + population_size * length;
+    }
+
+    // Every individual references its chunks. Each generation, every individual copies the chunks it mutates, so the
+    // chunks alive at once are the elite's and those copies.
+    const std::size_t chunks = (length + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    const double touched = 1 - std::pow(1 - std::clamp(mutation_chance, 0.0, 1.0), static_cast<double>(CHUNK_SIZE));
+    const auto copies = static_cast<std::size_t>(std::ceil(static_cast<double>(population_size * chunks) * touched));
+    const std::size_t chunk_bytes = CHUNK_SIZE + sizeof(std::uint32_t);
+
+    return shared + population_size * chunks * sizeof(std::uint32_t) + (2 * chunks + copies) * chunk_bytes;
+
+}
+
+
+bool parse_bytes(const std::string &text, std::size_t &bytes) {
+
+    if (text.empty() || !std::isdigit(static_cast<unsigned char>(text.front()))) {
+        return false;
+    }
+
+    char *end = nullptr;
+    errno = 0;
+    const unsigned long long amount = std::strtoull(text.c_str(), &end, 10);
+    if (errno != 0) {
+        return false;
+    }
+
+    const std::string suffix = end;
+    int shift;
+    if (suffix.empty()) {
+        shift = 0;
+    } else if (suffix == "K" || suffix == "k") {
+        shift = 10;
+    } else if (suffix == "M" || suffix == "m") {
+        shift = 20;
+    } else if (suffix == "G" || suffix == "g") {
+        shift = 30;
+    } else {
+        return false;
+    }
+
+    // An amount too large for a std::size_t once scaled is rejected, rather than wrapped to some smaller budget.
+    if (amount > (SIZE_MAX >> shift)) {
+        return false;
+    }
+
+    bytes = static_cast<std::size_t>(amount) << shift;
+    return true;
+
+}
+
+
+AdmissionController::Ticket::Ticket(AdmissionController &controller, const std::size_t bytes)
+        : controller(controller), bytes(bytes) {
+
+    std::unique_lock<std::mutex> lock(controller.mutex);
+
+    const std::uint64_t number = controller.next_number++;
+    if (number != controller.serving || controller.reserved + bytes > controller.limit) {
+        controller.waited++;
+        controller.released.wait(lock, [&]() {
+            return number == controller.serving && controller.reserved + bytes <= controller.limit;
+        });
+    }
+
+    controller.serving++;
+    controller.reserved += bytes;
+    controller.peak_reserved = std::max(controller.peak_reserved, controller.reserved);
+
+    // The next job in line may fit alongside this one.
+    controller.released.notify_all();
+
+}
+
+
+AdmissionController::Ticket::~Ticket() {
+
+    {
+        const std::lock_guard<std::mutex> lock(controller.mutex);
+        controller.reserved -= bytes;
+    }
+    controller.released.notify_all();
+
+}
@@ -0,0 +1,111 @@
+#ifndef ADMISSION_H
+#define ADMISSION_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+
+/**
+ * Estimates the memory an evolution needs for its population, from its configuration alone.
+ *
+ * @param population_size How many individuals the population is comprised of.
+ * @param length The length of every individual.
+ * @param mutation_chance The chance for each value to mutate, which decides how many chunks are copied when chunked.
+ * @param chunked If genomes are stored as shared chunks, as by {@link ChunkedEvolution}, rather than flat.
+ *
+ * @return The estimated footprint in bytes.
+ */
+std::size_t estimate_footprint(std::size_t population_size, std::size_t length, double mutation_chance, bool chunked);
+
+/**
+ * Parses an amount of memory, such as "4096", "512K", "64M" or "2G", where the suffixes are powers of 1024.
+ *
+ * @param text The amount.
+ * @param bytes The amount in bytes, which is only written to if it was parsed.
+ *
+ * @return If the amount was parsed, which it is not if it is too large for a std::size_t.
+ */
+bool parse_bytes(const std::string &text, std::size_t &bytes);
+
+
+/**
+ * Admits concurrent jobs against a global memory budget. A job reserves its estimated footprint before it allocates
+ * anything, and waits until enough of the budget is free if it is not. Jobs are admitted in the order they asked, so
+ * a large job is not starved by a stream of small ones.
+ */
+class AdmissionController {
+
+public:
+
+    /**
+     * @param budget The most memory that admitted jobs may reserve at once, in bytes.
+     */
+    explicit AdmissionController(std::size_t budget) : limit(budget) {}
+
+    /**
+     * A reservation of memory from the budget, which is returned when it is destroyed.
+     */
+    class Ticket {
+
+    public:
+
+        /**
+         * Waits until the memory can be reserved, and reserves it.
+         *
+         * @param controller The controller to reserve from.
+         * @param bytes The amount of memory, which must fit within the budget.
+         */
+        Ticket(AdmissionController &controller, std::size_t bytes);
+        Ticket(const Ticket &) = delete;
+        Ticket &operator=(const Ticket &) = delete;
+        ~Ticket();
+
+    private:
+
+        AdmissionController &controller;
+        std::size_t bytes;
+
+    };
+
+    /**
+     * @return The most memory that admitted jobs may reserve at once, in bytes.
+     */
+    [[nodiscard]] std::size_t budget() const {
+        return limit;
+    }
+
+    /**
+     * @return The most memory that was reserved at once, in bytes.
+     */
+    [[nodiscard]] std::size_t peak() const {
+        const std::lock_guard<std::mutex> lock(mutex);
+        return peak_reserved;
+    }
+
+    /**
+     * @return How many jobs had to wait before they were admitted.
+     */
+    [[nodiscard]] std::uint64_t queued() const {
+        const std::lock_guard<std::mutex> lock(mutex);
+        return waited;
+    }
+
+private:
+
+    const std::size_t limit;
+
+    mutable std::mutex mutex;
+    std::condition_variable released;
+    std::size_t reserved = 0;
+    std::size_t peak_reserved = 0;
+    std::uint64_t waited = 0;
+
+    /// Every job is given a number when it asks, and jobs are admitted in the order of their numbers.
+    std::uint64_t next_number = 0;
+    std::uint64_t serving = 0;
+
+};
+
+#endif
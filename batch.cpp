@@ -0,0 +1,93 @@
+#include "batch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <optional>
+
+#include "chunked.h"
+#include "population.h"
+#include "threads.h"
+
+
+CachedResult solve(const EvolutionSettings &settings, const std::size_t population_size, const std::uint64_t seed) {
+
+    Population population(population_size, settings.target.length());
+    WorkerPool pool(1, {});
+
+    Evolution evolution(settings, population, pool, nullptr, seed);
+    evolution.reset(starting_individual(settings.target.length(), seed));
+
+    Evolution::Generation result{};
+    do {
+        result = evolution.step();
+    } while (!result.solved);
+
+    return {std::string(evolution.best()), result.number, result.score};
+
+}
+
+
+CachedResult solve_chunked(const EvolutionSettings &settings, const std::size_t population_size,
+                           const std::uint64_t seed) {
+
+    ChunkedEvolution evolution(settings, population_size, seed);
+    evolution.reset(starting_individual(settings.target.length(), seed));
+
+    Evolution::Generation result{};
+    do {
+        result = evolution.step();
+    } while (!result.solved);
+
+    return {std::string(evolution.best()), result.number, result.score};
+
+}
+
+
+std::vector<BatchResult> run_batch(const std::vector<std::string> &targets, const EvolutionSettings &settings,
+                                   const std::size_t population_size, const std::uint64_t seed,
+                                   const std::string &parameters, const std::size_t threads, ResultCache &cache,
+                                   AdmissionController *admission) {
+
+    std::vector<BatchResult> results(targets.size());
+    WorkerPool pool(std::max<std::size_t>(threads, 1), {});
+
+    // Each worker claims the next job until none are left, so a long job does not hold up the others.
+    std::atomic<std::size_t> next = 0;
+    pool.run([&](std::size_t) {
+        for (std::size_t i = next.fetch_add(1); i < targets.size(); i = next.fetch_add(1)) {
+
+            EvolutionSettings job_settings = settings;
+            job_settings.target = targets[i];
+            results[i].target = targets[i];
+
+            // Degrade a job that does not fit the budget to chunked genomes, or reject it if even those do not fit.
+            const std::size_t length = targets[i].length();
+            std::size_t footprint = estimate_footprint(population_size, length, settings.mutation_chance, false);
+            if (admission != nullptr && footprint > admission->budget()) {
+                footprint = estimate_footprint(population_size, length, settings.mutation_chance, true);
+                results[i].degraded = true;
+                results[i].rejected = footprint > admission->budget();
+            }
+            if (results[i].rejected) {
+                continue;
+            }
+
+            // Chunked genomes evolve differently, so their results are cached apart.
+            const char *storage = results[i].degraded ? " chunked=1" : " chunked=0";
+            const std::string key = cache_key(targets[i], parameters + storage, seed);
+            results[i].result = cache.get_or_compute(key, [&]() {
+                std::optional<AdmissionController::Ticket> ticket;
+                if (admission != nullptr) {
+                    ticket.emplace(*admission, footprint);
+                }
+                return results[i].degraded
+                       ? solve_chunked(job_settings, population_size, seed)
+                       : solve(job_settings, population_size, seed);
+            }, results[i].source);
+
+        }
+    });
+
+    return results;
+
+}
@@ -0,0 +1,75 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "admission.h"
+#include "cache.h"
+#include "engine.h"
+
+
+/**
+ * The outcome of a single job of a batch.
+ */
+struct BatchResult {
+
+    /// The target of the job.
+    std::string target;
+
+    /// The result of the job.
+    CachedResult result;
+
+    /// Where the result came from.
+    ResultSource source = ResultSource::COMPUTED;
+
+    /// If the job was too large for the memory budget with flat genomes, and was run with chunked genomes instead.
+    bool degraded = false;
+
+    /// If the job was too large for the memory budget even with chunked genomes, and was not run.
+    bool rejected = false;
+
+};
+
+/**
+ * Evolves a random individual into a target on the calling thread, with the built-in fitness function.
+ *
+ * @param settings The settings of the evolution, including the target.
+ * @param population_size How many individuals the population is comprised of.
+ * @param seed The seed of the starting individual and of the mutations.
+ *
+ * @return The result of the evolution.
+ */
+CachedResult solve(const EvolutionSettings &settings, std::size_t population_size, std::uint64_t seed);
+
+/**
+ * Evolves a random individual into a target like {@link solve}, but with chunked genomes, which need far less memory
+ * for large populations of long genomes.
+ */
+CachedResult solve_chunked(const EvolutionSettings &settings, std::size_t population_size, std::uint64_t seed);
+
+/**
+ * Solves a batch of targets, several at once, through a cache. Targets that recur within the batch are only solved
+ * once, as later jobs wait for the first one's result, and targets solved by earlier batches are read from the cache.
+ *
+ * Jobs that are solved are admitted against a memory budget by their estimated footprint, and wait while it is spent.
+ * A job that would not fit the budget on its own is run with chunked genomes if those fit, and rejected otherwise.
+ *
+ * @param targets The target of every job.
+ * @param settings The settings of every evolution, apart from its target.
+ * @param population_size How many individuals each population is comprised of.
+ * @param seed The seed of every job.
+ * @param parameters Every setting that changes the outcome, which results are cached under along with the target and
+ *                   whether the job was evolved with chunked genomes.
+ * @param threads How many jobs run at once, each on its own thread.
+ * @param cache The cache of results.
+ * @param admission The memory budget that jobs are admitted against, if any.
+ *
+ * @return The outcome of every job, in the order of the targets.
+ */
+std::vector<BatchResult> run_batch(const std::vector<std::string> &targets, const EvolutionSettings &settings,
+                                   std::size_t population_size, std::uint64_t seed, const std::string &parameters,
+                                   std::size_t threads, ResultCache &cache, AdmissionController *admission);
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef BATCH_FITNESS_H
+#define BATCH_FITNESS_H
+
+#include <string>
+#include <vector>
+
+#include "population.h"
+
+
+/**
+ * A fitness function that scores a whole population at once, in place of the built-in fitness function. Scores are
+ * within [0, 1], and a score of 1 or more ends the search.
+ */
+class BatchFitness {
+
+public:
+
+    /// How many individuals are evaluated together, which amortizes the cost of dispatch over the tile.
+    static constexpr std::size_t TILE_SIZE = 64;
+
+    virtual ~BatchFitness() = default;
+
+    /**
+     * Scores a population.
+     *
+     * @param population The individuals to score, which must all be as long as the target.
+     * @param target The target value for the mutations.
+     * @param scores The output scores, which is resized to fit the population.
+     */
+    virtual void evaluate(const Population &population, const std::string &target,
+                          std::vector<double> &scores) = 0;
+
+    /**
+     * @return If {@link evaluate} may be called from several threads at once.
+     */
+    [[nodiscard]] virtual bool reentrant() const {
+        return false;
+    }
+
+};
+
+#endif
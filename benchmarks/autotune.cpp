@@ -0,0 +1,128 @@
+/**
+ * Finds the population size and mutation chance that reach the targets of a workload in the fewest evaluations, by
+ * racing every combination of them against each other and eliminating the worse half every round.
+ *
+ * Usage: autotune <workload> [--populations <size>,...] [--mutation-chances <chance>,...] [--runs <count>]
+ *                 [--threads <count>] [--max-evaluations <count>] [--graded] [--sparse]
+ *
+ * The mutation chances default to multiples of one mutation per individual, as the best chance shrinks as the targets
+ * grow longer. Runs are executed in parallel on one thread per CPU, unless '--threads' is given.
+ */
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "threads.h"
+#include "tuning.h"
+#include "workload.h"
+
+
+namespace {
+
+    /// Splits a comma separated list.
+    std::vector<std::string> split(const std::string &list) {
+        std::vector<std::string> items;
+        std::istringstream stream(list);
+        for (std::string item; std::getline(stream, item, ',');) {
+            items.push_back(item);
+        }
+        return items;
+    }
+
+}
+
+
+int main(const int argc, const char *argv[]) {
+
+    const std::vector<std::string> args(argv, argv + argc);
+
+    if (args.size() < 2 || find_workload(args[1]) == nullptr) {
+        std::cerr << "Usage: autotune <workload> [options], where the workload is one of:";
+        for (const WorkloadProfile &profile : workload_profiles()) {
+            std::cerr << ' ' << profile.name;
+        }
+        std::cerr << std::endl;
+        return 1;
+    }
+
+    const WorkloadProfile &profile = *find_workload(args[1]);
+    const std::vector<std::string> targets = generate_targets(profile);
+
+    const double mean_length = std::accumulate(targets.begin(), targets.end(), 0.0,
+                                               [](const double total, const std::string &target) {
+                                                   return total + static_cast<double>(target.length());
+                                               }) / static_cast<double>(targets.size());
+
+    std::vector<std::size_t> populations = {25, 50, 100, 200, 400, 800};
+    std::vector<double> mutation_chances;
+    for (const double mutations : {0.25, 0.5, 1.0, 2.0, 4.0, 8.0}) {
+        mutation_chances.push_back(std::min(mutations / mean_length, 0.5));
+    }
+
+    RaceSettings settings;
+    settings.threads = place_threads(detect_topology(), 0, false).size();
+
+    for (std::size_t i = 2; i < args.size(); i++) {
+        if (args[i] == "--populations" && i + 1 < args.size()) {
+            populations.clear();
+            for (const std::string &item : split(args[++i])) {
+                populations.push_back(std::stoull(item));
+            }
+        } else if (args[i] == "--mutation-chances" && i + 1 < args.size()) {
+            mutation_chances.clear();
+            for (const std::string &item : split(args[++i])) {
+                mutation_chances.push_back(std::stod(item));
+            }
+        } else if (args[i] == "--runs" && i + 1 < args.size()) {
+            settings.initial_runs = std::stoi(args[++i]);
+        } else if (args[i] == "--threads" && i + 1 < args.size()) {
+            settings.threads = std::stoull(args[++i]);
+        } else if (args[i] == "--max-evaluations" && i + 1 < args.size()) {
+            settings.max_evaluations = std::stoull(args[++i]);
+        } else if (args[i] == "--graded") {
+            settings.fitness_mode = FitnessMode::GRADED;
+        } else if (args[i] == "--sparse") {
+            settings.sparse = true;
+        }
+    }
+
+    // The same ranges that the program accepts.
+    const bool valid = std::all_of(populations.begin(), populations.end(), [](const std::size_t size) {
+        return size > 0;
+    }) && std::all_of(mutation_chances.begin(), mutation_chances.end(), [](const double chance) {
+        return chance >= 0 && chance <= 1;
+    }) && settings.threads > 0;
+    if (!valid) {
+        std::cerr << "Populations and threads must be at least 1, and mutation chances within [0, 1]" << std::endl;
+        return 1;
+    }
+
+    const std::vector<TuningCandidate> candidates = tuning_grid(populations, mutation_chances);
+    if (candidates.empty()) {
+        std::cerr << "No candidates to race" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Racing " << candidates.size() << " candidates on " << profile.name << " (workload version "
+              << WORKLOAD_VERSION << ") with " << settings.threads << " threads" << std::endl;
+
+    const std::vector<TuningResult> results = race(candidates, targets, settings);
+
+    std::cout << "population,mutation_chance,eliminated,runs,solved,mean_evaluations,mean_seconds\n";
+    for (const TuningResult &result : results) {
+        std::cout << result.candidate.population << ',' << result.candidate.mutation_chance << ','
+                  << result.eliminated << ',' << result.runs << ',' << result.solved << ',' << result.mean_cost()
+                  << ',' << result.seconds / result.runs << '\n';
+    }
+
+    const TuningResult &best = results.front();
+    std::cout << "Best configuration for " << profile.name << ": --population " << best.candidate.population
+              << " --mutation-chance " << best.candidate.mutation_chance << " (" << best.solved << "/" << best.runs
+              << " solved, " << best.mean_cost() << " evaluations on average)" << std::endl;
+
+    return 0;
+
+}
@@ -0,0 +1,254 @@
+/**
+ * Measures how the engine scales across threads by running full evolutions against synthetic workloads.
+ *
+ * Strong scaling keeps each workload fixed while the thread count grows. Weak scaling grows the population with the
+ * thread count, so that every thread always has the same amount of work. As the amount of generations needed to reach
+ * the target varies from run to run, speedup and efficiency are measured from throughput (evaluations per second)
+ * rather than from the time taken to reach the target. Runs that have not reached their target after the maximum
+ * amount of generations are stopped, and still count towards throughput.
+ *
+ * Usage: scaling_benchmark [--max-threads <count>] [--workloads <name>,...] [--weak <name>] [--repeat <count>]
+ *                          [--max-generations <count>] [--sparse] [--format csv|json]
+ *
+ * The workloads are the canned profiles in workload.h, and default to all of them.
+ */
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "engine.h"
+#include "population.h"
+#include "threads.h"
+#include "workload.h"
+
+
+namespace {
+
+    /// The totals of every run of a single configuration.
+    struct Measurement {
+        std::string scaling;
+        std::string workload;
+        std::size_t population;
+        std::size_t threads;
+        int runs = 0;
+        int solved = 0;
+        std::uint64_t generations = 0;
+        std::uint64_t evaluations = 0;
+        double seconds = 0;
+    };
+
+    /**
+     * Runs full evolutions of a single configuration, cycling through the targets of a workload.
+     *
+     * @param profile The workload.
+     * @param targets The targets of the workload.
+     * @param population_size How many individuals each population is comprised of.
+     * @param threads How many worker threads to use.
+     * @param repeat How many evolutions to run.
+     * @param max_generations The most generations a single evolution may run for before it is stopped.
+     * @param sparse If the sparse mutation kernel is used.
+     *
+     * @return The totals of every run.
+     */
+    Measurement measure(const WorkloadProfile &profile, const std::vector<std::string> &targets,
+                        const std::size_t population_size, const std::size_t threads, const int repeat,
+                        const int max_generations, const bool sparse) {
+
+        Measurement measurement{"", profile.name, population_size, threads};
+        WorkerPool pool(threads, {});
+
+        for (int run = 0; run < repeat; run++) {
+
+            const std::string &target = targets[run % targets.size()];
+            Population population(population_size, target.length());
+
+            // Every configuration starts from the same individual for the same run.
+            const std::string start = starting_individual(target.length(), run);
+
+            EvolutionSettings settings{target};
+            settings.sparse = sparse;
+
+            Evolution evolution(settings, population, pool, nullptr, run);
+            evolution.reset(start);
+
+            const auto begin = std::chrono::steady_clock::now();
+            Evolution::Generation result{};
+            do {
+                result = evolution.step();
+            } while (!result.solved && result.number < max_generations);
+            const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+            measurement.runs++;
+            measurement.solved += result.solved;
+            measurement.generations += result.number;
+            measurement.evaluations += static_cast<std::uint64_t>(result.number) * population_size;
+            measurement.seconds += elapsed.count();
+
+        }
+
+        return measurement;
+
+    }
+
+    /// Splits a comma separated list.
+    std::vector<std::string> split(const std::string &list) {
+        std::vector<std::string> items;
+        std::istringstream stream(list);
+        for (std::string item; std::getline(stream, item, ',');) {
+            items.push_back(item);
+        }
+        return items;
+    }
+
+}
+
+
+int main(const int argc, const char *argv[]) {
+
+    std::size_t max_threads = place_threads(detect_topology(), 0, false).size();
+    std::vector<std::string> workloads;
+    std::string weak = "short-text";
+    int repeat = 3;
+    int max_generations = 1000;
+    bool sparse = false;
+    bool json = false;
+
+    for (const WorkloadProfile &profile : workload_profiles()) {
+        workloads.push_back(profile.name);
+    }
+
+    const std::vector<std::string> args(argv, argv + argc);
+
+    // The counts are converted with std::stoull and std::stoi, which throw if an argument is not a number.
+    try {
+        for (std::size_t i = 1; i < args.size(); i++) {
+            if (args[i] == "--max-threads" && i + 1 < args.size()) {
+                max_threads = std::stoull(args[++i]);
+            } else if (args[i] == "--workloads" && i + 1 < args.size()) {
+                workloads = split(args[++i]);
+            } else if (args[i] == "--weak" && i + 1 < args.size()) {
+                weak = args[++i];
+            } else if (args[i] == "--repeat" && i + 1 < args.size()) {
+                repeat = std::stoi(args[++i]);
+            } else if (args[i] == "--max-generations" && i + 1 < args.size()) {
+                max_generations = std::stoi(args[++i]);
+            } else if (args[i] == "--sparse") {
+                sparse = true;
+            } else if (args[i] == "--format" && i + 1 < args.size()) {
+                json = args[++i] == "json";
+            }
+        }
+    } catch (const std::logic_error &) {
+        std::cerr << "Failed to parse arguments: --max-threads, --repeat and --max-generations take whole numbers"
+                  << std::endl;
+        return 1;
+    }
+
+    for (const std::string &name : workloads) {
+        if (find_workload(name) == nullptr) {
+            std::cerr << "Unknown workload: " << name << std::endl;
+            return 1;
+        }
+    }
+    if (find_workload(weak) == nullptr) {
+        std::cerr << "Unknown workload: " << weak << std::endl;
+        return 1;
+    }
+    if (max_threads == 0) {
+        std::cerr << "The maximum thread count must be at least 1" << std::endl;
+        return 1;
+    }
+    if (repeat < 1) {
+        std::cerr << "The repeat count must be at least 1" << std::endl;
+        return 1;
+    }
+
+    // Thread counts double up to the maximum, which is always included.
+    std::vector<std::size_t> thread_counts;
+    for (std::size_t threads = 1; threads < max_threads; threads *= 2) {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(max_threads);
+
+    std::vector<Measurement> measurements;
+
+    for (const std::string &name : workloads) {
+
+        const WorkloadProfile &profile = *find_workload(name);
+        const std::vector<std::string> targets = generate_targets(profile);
+
+        for (const std::size_t threads : thread_counts) {
+            measurements.push_back(measure(profile, targets, profile.population, threads, repeat, max_generations,
+                                           sparse));
+            measurements.back().scaling = "strong";
+        }
+
+    }
+
+    {
+        const WorkloadProfile &profile = *find_workload(weak);
+        const std::vector<std::string> targets = generate_targets(profile);
+
+        for (const std::size_t threads : thread_counts) {
+            measurements.push_back(measure(profile, targets, profile.population * threads, threads, repeat,
+                                           max_generations, sparse));
+            measurements.back().scaling = "weak";
+        }
+    }
+
+    if (json) {
+        std::cout << "[\n";
+    } else {
+        std::cout << "workload_version,scaling,workload,population,threads,runs,solved,generations,seconds,"
+                     "generations_per_second,evaluations_per_second,evaluations_per_second_per_core,speedup,"
+                     "efficiency\n";
+    }
+
+    // The baseline of each group is its single-threaded run, which always comes first.
+    std::size_t baseline = 0;
+
+    for (std::size_t i = 0; i < measurements.size(); i++) {
+
+        const Measurement &measurement = measurements[i];
+        if (measurement.threads == 1) {
+            baseline = i;
+        }
+
+        const auto throughput = static_cast<double>(measurement.evaluations) / measurement.seconds;
+        const auto baseline_throughput = static_cast<double>(measurements[baseline].evaluations)
+                                         / measurements[baseline].seconds;
+        const double speedup = throughput / baseline_throughput;
+        const double efficiency = speedup / static_cast<double>(measurement.threads);
+        const double per_core = throughput / static_cast<double>(measurement.threads);
+        const double generations_per_second = static_cast<double>(measurement.generations) / measurement.seconds;
+
+        if (json) {
+            std::cout << "  {\"workload_version\": " << WORKLOAD_VERSION << ", \"scaling\": \"" << measurement.scaling
+                      << "\", \"workload\": \"" << measurement.workload << "\", \"population\": "
+                      << measurement.population << ", \"threads\": " << measurement.threads << ", \"runs\": "
+                      << measurement.runs << ", \"solved\": " << measurement.solved << ", \"generations\": "
+                      << measurement.generations << ", \"seconds\": " << measurement.seconds
+                      << ", \"generations_per_second\": " << generations_per_second
+                      << ", \"evaluations_per_second\": " << throughput << ", \"evaluations_per_second_per_core\": "
+                      << per_core << ", \"speedup\": " << speedup << ", \"efficiency\": " << efficiency << "}"
+                      << (i + 1 < measurements.size() ? "," : "") << '\n';
+        } else {
+            std::cout << WORKLOAD_VERSION << ',' << measurement.scaling << ',' << measurement.workload << ','
+                      << measurement.population << ',' << measurement.threads << ',' << measurement.runs << ','
+                      << measurement.solved << ',' << measurement.generations << ',' << measurement.seconds << ','
+                      << generations_per_second << ',' << throughput << ',' << per_core << ',' << speedup << ','
+                      << efficiency << '\n';
+        }
+
+    }
+
+    if (json) {
+        std::cout << "]\n";
+    }
+
+    return 0;
+
+}
@@ -0,0 +1,82 @@
+/**
+ * Prints the targets of a synthetic workload, one per line, after a header describing the workload.
+ *
+ * Usage: workload_generator [<profile>] [--targets <count>] [--length <min>-<max>] [--alphabet <size>]
+ *                           [--entropy <bits>] [--similarity <fraction>] [--seed <seed>]
+ *
+ * With no profile, the canned profiles in workload.h are listed. The options override the profile's settings.
+ */
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "workload.h"
+
+
+int main(const int argc, const char *argv[]) {
+
+    const std::vector<std::string> args(argv, argv + argc);
+
+    if (args.size() < 2) {
+        for (const WorkloadProfile &profile : workload_profiles()) {
+            std::cout << profile.name << ": " << profile.targets << " targets of " << profile.min_length << "-"
+                      << profile.max_length << " characters from " << profile.alphabet << " at " << profile.entropy
+                      << " bits, " << profile.similarity << " similar, population " << profile.population << '\n';
+        }
+        return 0;
+    }
+
+    const WorkloadProfile *found = find_workload(args[1]);
+    if (found == nullptr) {
+        std::cerr << "Unknown workload: " << args[1] << std::endl;
+        return 1;
+    }
+
+    WorkloadProfile profile = *found;
+    for (std::size_t i = 2; i + 1 < args.size(); i += 2) {
+        if (args[i] == "--targets") {
+            profile.targets = std::stoull(args[i + 1]);
+        } else if (args[i] == "--length") {
+            const std::size_t separator = args[i + 1].find('-');
+            profile.min_length = std::stoull(args[i + 1].substr(0, separator));
+            profile.max_length = separator == std::string::npos
+                                 ? profile.min_length
+                                 : std::stoull(args[i + 1].substr(separator + 1));
+        } else if (args[i] == "--alphabet") {
+            profile.alphabet = std::stoull(args[i + 1]);
+        } else if (args[i] == "--entropy") {
+            profile.entropy = std::stod(args[i + 1]);
+        } else if (args[i] == "--similarity") {
+            profile.similarity = std::stod(args[i + 1]);
+        } else if (args[i] == "--seed") {
+            profile.seed = std::stoull(args[i + 1]);
+        }
+    }
+
+    if (profile.min_length == 0 || profile.min_length > profile.max_length) {
+        std::cerr << "Invalid length: " << profile.min_length << "-" << profile.max_length
+                  << ", targets must be at least 1 character and the minimum may not be above the maximum" << std::endl;
+        return 1;
+    }
+
+    const std::vector<std::string> targets = generate_targets(profile);
+
+    double similarity = 0;
+    for (std::size_t i = 1; i < targets.size(); i++) {
+        similarity += measure_similarity(targets[0], targets[i]);
+    }
+
+    std::cout << "# workload " << profile.name << " version " << WORKLOAD_VERSION << '\n';
+    std::cout << "# entropy " << measure_entropy(targets) << " bits";
+    if (targets.size() > 1) {
+        std::cout << ", similarity to the first target " << similarity / static_cast<double>(targets.size() - 1);
+    }
+    std::cout << '\n';
+
+    for (const std::string &target : targets) {
+        std::cout << target << '\n';
+    }
+
+    return 0;
+
+}
@@ -0,0 +1,281 @@
+#include "cache.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+namespace {
+
+    /// The first line of every result file, which changes whenever the format does.
+    constexpr std::string_view HEADER = "cool-topics-result 1";
+
+    /// The extension of result files.
+    constexpr const char *RESULT = ".result";
+
+    /// The extension of lock files.
+    constexpr const char *LOCK = ".lock";
+
+}
+
+
+std::uint64_t fnv1a(const std::string_view data) {
+
+    std::uint64_t hash = 0xCBF29CE484222325ULL;
+    for (const char c : data) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001B3ULL;
+    }
+
+    return hash;
+
+}
+
+
+std::string cache_key(const std::string_view target, const std::string_view parameters, const std::uint64_t seed) {
+
+    // The target is length-prefixed, so no target can run into the parameters.
+    std::ostringstream key;
+    key << target.length() << ':' << target << ' ' << parameters << " seed=" << seed;
+
+    return key.str();
+
+}
+
+
+std::string ResultCache::open(const std::string &path, const std::size_t result_capacity) {
+
+    if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) {
+        return "could not create " + path + ": " + std::strerror(errno);
+    }
+
+    struct stat status{};
+    if (stat(path.c_str(), &status) != 0 || !S_ISDIR(status.st_mode)) {
+        return path + " is not a directory";
+    }
+
+    directory = path;
+    capacity = std::max<std::size_t>(result_capacity, 1);
+
+    return "";
+
+}
+
+
+std::string ResultCache::path(const std::string &key, const char *extension) const {
+
+    // Files are named by the hash of the key, and hold the key itself so that collisions are told apart.
+    char name[17];
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(fnv1a(key)));
+
+    return directory + "/" + name + extension;
+
+}
+
+
+bool ResultCache::lookup(const std::string &key, CachedResult &result) {
+
+    if (directory.empty()) {
+        return false;
+    }
+
+    const std::string file_path = path(key, RESULT);
+    std::ifstream file(file_path, std::ios::binary);
+
+    // The header line is followed by the lengths of the key and the best individual, the generations and the score,
+    // and then by the key and the best individual themselves, which may hold any character.
+    std::string header;
+    std::size_t key_length = 0;
+    std::size_t best_length = 0;
+    CachedResult found;
+
+    if (!std::getline(file, header) || header != HEADER
+        || !(file >> key_length >> best_length >> found.generations >> found.score) || file.get() != '\n') {
+        return false;
+    }
+
+    std::string stored_key(key_length, '\0');
+    found.best.resize(best_length);
+    if (!file.read(stored_key.data(), static_cast<std::streamsize>(key_length)) || stored_key != key
+        || !file.read(found.best.data(), static_cast<std::streamsize>(best_length))) {
+        return false;
+    }
+
+    // Mark the result as recently used.
+    utimensat(AT_FDCWD, file_path.c_str(), nullptr, 0);
+
+    result = std::move(found);
+    return true;
+
+}
+
+
+bool ResultCache::store(const std::string &key, const CachedResult &result) {
+
+    if (directory.empty()) {
+        return false;
+    }
+
+    // Write to a temporary file and rename it over the result, so that readers never see a partial result.
+    const std::string file_path = path(key, RESULT);
+    const std::string temporary_path = file_path + "." + std::to_string(getpid());
+    {
+        std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+        file.precision(17);
+        file << HEADER << '\n' << key.length() << ' ' << result.best.length() << ' ' << result.generations << ' '
+             << result.score << '\n' << key << result.best;
+        if (!file) {
+            std::remove(temporary_path.c_str());
+            return false;
+        }
+    }
+
+    if (std::rename(temporary_path.c_str(), file_path.c_str()) != 0) {
+        std::remove(temporary_path.c_str());
+        return false;
+    }
+
+    evict();
+    return true;
+
+}
+
+
+void ResultCache::evict() {
+
+    DIR *listing = opendir(directory.c_str());
+    if (listing == nullptr) {
+        return;
+    }
+
+    // Gather every result with the time it was last used.
+    std::vector<std::pair<timespec, std::string>> results;
+    while (const dirent *entry = readdir(listing)) {
+
+        const std::string name = entry->d_name;
+        const std::size_t extension = std::strlen(RESULT);
+        if (name.length() <= extension || name.compare(name.length() - extension, extension, RESULT) != 0) {
+            continue;
+        }
+
+        struct stat status{};
+        if (const std::string file_path = directory + "/" + name; stat(file_path.c_str(), &status) == 0) {
+            results.emplace_back(status.st_mtim, file_path);
+        }
+
+    }
+    closedir(listing);
+
+    if (results.size() <= capacity) {
+        return;
+    }
+
+    // Delete the least recently used, oldest first.
+    const auto oldest = results.begin() + static_cast<std::ptrdiff_t>(results.size() - capacity);
+    std::nth_element(results.begin(), oldest, results.end(), [](const auto &a, const auto &b) {
+        return a.first.tv_sec < b.first.tv_sec
+               || (a.first.tv_sec == b.first.tv_sec && a.first.tv_nsec < b.first.tv_nsec);
+    });
+    for (auto result = results.begin(); result != oldest; ++result) {
+        std::remove(result->second.c_str());
+    }
+
+}
+
+
+ResultCache::Lock::Lock(const ResultCache &cache, const std::string &key) {
+
+    if (cache.directory.empty()) {
+        return;
+    }
+
+    // The holder of a lock deletes its file before letting go of it, so a file that was locked after waiting may no
+    // longer be the one at the path, in which case the path is opened and locked again.
+    file_path = cache.path(key, LOCK);
+    for (;;) {
+
+        descriptor = ::open(file_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (descriptor < 0) {
+            return;
+        }
+        while (flock(descriptor, LOCK_EX) != 0 && errno == EINTR) {
+        }
+
+        struct stat locked{};
+        struct stat current{};
+        if (fstat(descriptor, &locked) == 0 && stat(file_path.c_str(), &current) == 0
+            && locked.st_dev == current.st_dev && locked.st_ino == current.st_ino) {
+            return;
+        }
+        close(descriptor);
+
+    }
+
+}
+
+
+ResultCache::Lock::~Lock() {
+
+    // The file is deleted while it is still locked, so that no other process can lock it in the meantime.
+    if (descriptor >= 0) {
+        unlink(file_path.c_str());
+        close(descriptor);
+    }
+
+}
+
+
+CachedResult ResultCache::get_or_compute(const std::string &key, const std::function<CachedResult()> &compute,
+                                         ResultSource &source) {
+
+    std::promise<CachedResult> promise;
+    std::unique_lock<std::mutex> lock(mutex);
+
+    // Wait for the same job if this process is already computing it.
+    if (const auto job = in_flight.find(key); job != in_flight.end()) {
+        const std::shared_future<CachedResult> result = job->second;
+        lock.unlock();
+        source = ResultSource::COALESCED;
+        return result.get();
+    }
+
+    in_flight.emplace(key, promise.get_future().share());
+    lock.unlock();
+
+    // Another process may be computing the same job, in which case its result is read once it lets go of the lock. If
+    // the job throws, the requests waiting for it are given the exception, and a later request runs it again.
+    CachedResult result;
+    try {
+        const Lock file_lock(*this, key);
+        if (lookup(key, result)) {
+            source = ResultSource::CACHED;
+        } else {
+            result = compute();
+            store(key, result);
+            source = ResultSource::COMPUTED;
+        }
+    } catch (...) {
+        promise.set_exception(std::current_exception());
+        lock.lock();
+        in_flight.erase(key);
+        throw;
+    }
+
+    promise.set_value(result);
+
+    lock.lock();
+    in_flight.erase(key);
+
+    return result;
+
+}
@@ -0,0 +1,163 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+
+/**
+ * The outcome of an evolution, as kept in a {@link ResultCache}.
+ */
+struct CachedResult {
+
+    /// The individual with the peak fitness score when the evolution ended.
+    std::string best;
+
+    /// How many generations the evolution ran for.
+    int generations = 0;
+
+    /// The peak fitness score.
+    double score = 0;
+
+};
+
+/**
+ * Where a result given by {@link ResultCache::get_or_compute} came from.
+ */
+enum class ResultSource {
+
+    /// The result was computed by the caller.
+    COMPUTED,
+
+    /// The result was found in the cache.
+    CACHED,
+
+    /// The result was computed by another caller that asked for the same key at the same time.
+    COALESCED
+
+};
+
+/**
+ * Caches the results of evolutions on disk, one file per result, so that recurring jobs are not solved again.
+ *
+ * The cache holds a fixed amount of results, and evicts the least recently used once it is full. Use is tracked by the
+ * modification time of each file, which is refreshed whenever a result is read, so the order survives between runs.
+ *
+ * Identical jobs that are in flight at the same time are coalesced, so only one of them runs. Within a process the
+ * others wait for its result, and across processes they wait on a lock file before reading the result it stored. Lock
+ * files are empty, and are deleted by the process holding them as it lets go.
+ *
+ * A cache that has not been opened keeps nothing, but still coalesces the jobs in flight within the process.
+ */
+class ResultCache {
+
+public:
+
+    /// How many results the cache holds unless told otherwise.
+    static constexpr std::size_t DEFAULT_CAPACITY = 1024;
+
+    /**
+     * Opens a cache directory, creating it if it does not exist.
+     *
+     * @param directory The directory of the cache.
+     * @param capacity How many results the cache holds before it evicts the least recently used.
+     *
+     * @return An empty string if the directory could be used, otherwise a description of the error.
+     */
+    std::string open(const std::string &directory, std::size_t capacity = DEFAULT_CAPACITY);
+
+    /**
+     * Reads a result, and marks it as recently used.
+     *
+     * @param key The key of the job, as given by {@link cache_key}.
+     * @param result The result, which is only written to if it was found.
+     *
+     * @return If the result was found.
+     */
+    bool lookup(const std::string &key, CachedResult &result);
+
+    /**
+     * Stores a result, and evicts the least recently used results beyond the capacity.
+     *
+     * @param key The key of the job, as given by {@link cache_key}.
+     * @param result The result.
+     *
+     * @return If the result was written.
+     */
+    bool store(const std::string &key, const CachedResult &result);
+
+    /**
+     * Gives the cached result of a job, computing and storing it if there is none. While a job is being computed, any
+     * other request for it waits for the same result instead of computing it again.
+     *
+     * @param key The key of the job, as given by {@link cache_key}.
+     * @param compute Runs the job. Anything it throws is rethrown to this request and to every request waiting for it.
+     * @param source Where the result came from.
+     *
+     * @return The result.
+     */
+    CachedResult get_or_compute(const std::string &key, const std::function<CachedResult()> &compute,
+                                ResultSource &source);
+
+    /**
+     * An exclusive lock on a key shared by every process using the cache, held until it is destroyed.
+     */
+    class Lock {
+
+    public:
+
+        Lock(const ResultCache &cache, const std::string &key);
+        Lock(const Lock &) = delete;
+        Lock &operator=(const Lock &) = delete;
+        ~Lock();
+
+    private:
+
+        std::string file_path;
+        int descriptor = -1;
+
+    };
+
+private:
+
+    /// Finds the file a key is stored in.
+    [[nodiscard]] std::string path(const std::string &key, const char *extension) const;
+
+    /// Deletes the least recently used results beyond the capacity.
+    void evict();
+
+    std::string directory;
+    std::size_t capacity = DEFAULT_CAPACITY;
+
+    /// The jobs being computed by this process, which later requests for the same key wait for.
+    std::mutex mutex;
+    std::unordered_map<std::string, std::shared_future<CachedResult>> in_flight;
+
+};
+
+/**
+ * Builds the key which the result of a job is cached under.
+ *
+ * @param target The target of the job.
+ * @param parameters Every other setting that changes the outcome, in a fixed order.
+ * @param seed The seed of the job.
+ *
+ * @return The key.
+ */
+std::string cache_key(std::string_view target, std::string_view parameters, std::uint64_t seed);
+
+/**
+ * Hashes a string with 64-bit FNV-1a, which is the same on every platform and in every run.
+ *
+ * @param data The string to hash.
+ *
+ * @return The hash.
+ */
+std::uint64_t fnv1a(std::string_view data);
+
+#endif
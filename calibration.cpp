@@ -0,0 +1,84 @@
+#include "calibration.h"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#include "cache.h"
+
+
+ExecutionPlan calibrate(const std::vector<ExecutionPlan> &candidates,
+                        const std::function<double(const ExecutionPlan &)> &measure) {
+
+    ExecutionPlan fastest = candidates.front();
+    double fastest_time = measure(fastest);
+
+    for (std::size_t i = 1; i < candidates.size(); i++) {
+        if (const double time = measure(candidates[i]); time < fastest_time) {
+            fastest = candidates[i];
+            fastest_time = time;
+        }
+    }
+
+    return fastest;
+
+}
+
+
+std::string calibration_key(const std::size_t population_size, const std::size_t length, const std::size_t cpus,
+                            const double mutation_chance, const std::string_view fitness) {
+
+    // The key must be a single word, so the fitness function, which may be an expression with spaces, is hashed.
+    char suffix[64];
+    std::snprintf(suffix, sizeof(suffix), "~%g/%016llx", mutation_chance,
+                  static_cast<unsigned long long>(fnv1a(fitness)));
+
+    return std::to_string(population_size) + "x" + std::to_string(length) + "@" + std::to_string(cpus) + suffix;
+
+}
+
+
+bool load_plan(const std::string &path, const std::string &key, ExecutionPlan &plan) {
+
+    // Each line of the file is a key followed by the plan, such as "100x41@8~0.01/cbf29ce484222325 4 1".
+    std::ifstream file(path);
+    std::string line;
+
+    while (std::getline(file, line)) {
+
+        std::istringstream fields(line);
+        std::string line_key;
+        ExecutionPlan line_plan;
+
+        if (fields >> line_key >> line_plan.threads >> line_plan.sparse && line_key == key && line_plan.threads > 0) {
+            plan = line_plan;
+            return true;
+        }
+
+    }
+
+    return false;
+
+}
+
+
+bool save_plan(const std::string &path, const std::string &key, const ExecutionPlan &plan) {
+
+    // Keep the plans of every other workload.
+    std::string kept;
+    {
+        std::ifstream file(path);
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.compare(0, key.length() + 1, key + " ") != 0) {
+                kept += line + '\n';
+            }
+        }
+    }
+
+    std::ofstream file(path, std::ios::trunc);
+    file << kept << key << ' ' << plan.threads << ' ' << plan.sparse << '\n';
+
+    return static_cast<bool>(file);
+
+}
@@ -0,0 +1,72 @@
+#ifndef CALIBRATION_H
+#define CALIBRATION_H
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+/**
+ * How the generation loop is executed.
+ */
+struct ExecutionPlan {
+
+    /// How many worker threads run the loop, where 1 runs it serially.
+    std::size_t threads = 1;
+
+    /// If mutation skips straight to the next mutated character, rather than drawing a random number for every one.
+    bool sparse = false;
+
+};
+
+/**
+ * Measures every candidate plan and chooses the fastest.
+ *
+ * @param candidates The plans to choose from, which must not be empty.
+ * @param measure Runs a plan for a short while, and returns the average time it took per generation in seconds.
+ *
+ * @return The fastest plan.
+ */
+ExecutionPlan calibrate(const std::vector<ExecutionPlan> &candidates,
+                        const std::function<double(const ExecutionPlan &)> &measure);
+
+/**
+ * Builds the key which a calibration is cached under. A cached plan is only reused for the same workload on the same
+ * CPUs, as the fastest plan depends on both. The mutation chance decides how much the sparse kernel saves, and the
+ * fitness function how much of each generation is spent outside of mutation.
+ *
+ * @param population_size How many individuals the population is comprised of.
+ * @param length The length of every individual.
+ * @param cpus How many CPUs are available to the process.
+ * @param mutation_chance The chance for each value to mutate.
+ * @param fitness A description of the fitness function, such as its mode or the plugin or expression that replaces it.
+ *
+ * @return The key.
+ */
+std::string calibration_key(std::size_t population_size, std::size_t length, std::size_t cpus,
+                            double mutation_chance, std::string_view fitness);
+
+/**
+ * Loads a cached plan from a calibration file.
+ *
+ * @param path The path of the calibration file.
+ * @param key The key of the plan, as given by {@link calibration_key}.
+ * @param plan The plan, which is only written to if it was found.
+ *
+ * @return If the plan was found.
+ */
+bool load_plan(const std::string &path, const std::string &key, ExecutionPlan &plan);
+
+/**
+ * Saves a plan to a calibration file, replacing any plan that was cached under the same key.
+ *
+ * @param path The path of the calibration file.
+ * @param key The key of the plan, as given by {@link calibration_key}.
+ * @param plan The plan.
+ *
+ * @return If the file was written.
+ */
+bool save_plan(const std::string &path, const std::string &key, const ExecutionPlan &plan);
+
+#endif
@@ -0,0 +1,174 @@
+#include "chunked.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "trace.h"
+
+
+ChunkedEvolution::ChunkedEvolution(EvolutionSettings settings, const std::size_t population_size,
+                                   const std::uint64_t seed)
+        : evolution_settings(std::move(settings)), population_size(population_size),
+          chunks_per_genome((evolution_settings.target.length() + CHUNK_SIZE - 1) / CHUNK_SIZE), random(stream_seed(seed, StreamPurpose::MUTATION)),
+          genomes(population_size * chunks_per_genome), errors(population_size), elite_chunks(chunks_per_genome) {
+
+    elite.reserve(evolution_settings.target.length());
+
+}
+
+
+std::uint32_t ChunkedEvolution::allocate_chunk() {
+
+    if (!free_chunks.empty()) {
+        const std::uint32_t chunk = free_chunks.back();
+        free_chunks.pop_back();
+        return chunk;
+    }
+
+    const auto chunk = static_cast<std::uint32_t>(references.size());
+    chunk_characters.resize(chunk_characters.size() + CHUNK_SIZE);
+    references.push_back(0);
+
+    return chunk;
+
+}
+
+
+void ChunkedEvolution::release_chunk(const std::uint32_t chunk) {
+    if (--references[chunk] == 0) {
+        free_chunks.push_back(chunk);
+    }
+}
+
+
+void ChunkedEvolution::reset(const std::string_view individual) {
+
+    // Start over with a single chunk for every position, shared by the elite and every individual.
+    chunk_characters.clear();
+    references.clear();
+    free_chunks.clear();
+
+    const std::string_view target = evolution_settings.target;
+    for (std::size_t c = 0; c < chunks_per_genome; c++) {
+
+        const std::size_t begin = c * CHUNK_SIZE;
+        const std::size_t length = std::min(CHUNK_SIZE, target.length() - begin);
+
+        const std::uint32_t chunk = allocate_chunk();
+        std::memcpy(&chunk_characters[chunk * CHUNK_SIZE], individual.data() + begin, length);
+        references[chunk] = static_cast<std::uint32_t>(population_size) + 1;
+        elite_chunks[c] = chunk;
+
+    }
+
+    const long individual_error = error(individual, target, evolution_settings.fitness_mode);
+    for (std::size_t i = 0; i < population_size; i++) {
+        std::copy(elite_chunks.begin(), elite_chunks.end(), genome(i));
+        errors[i] = individual_error;
+    }
+
+    elite = individual;
+    generation = 0;
+
+}
+
+
+void ChunkedEvolution::mutate_individual(const std::size_t individual) {
+
+    // Gaps are drawn like those of mutate_sparse, and capped in the same way.
+    const double log_keep = std::log1p(-evolution_settings.mutation_chance);
+    if (!(log_keep < 0)) {
+        return;
+    }
+
+    std::uint32_t *chunks = genome(individual);
+    const std::string &target = evolution_settings.target;
+    const auto length = static_cast<double>(target.length());
+    const auto gap = [&]() {
+        return static_cast<std::size_t>(std::min(std::log(1.0 - random.chance()) / log_keep, length));
+    };
+
+    for (std::size_t i = gap(); i < target.length(); i += gap() + 1) {
+
+        std::uint32_t &chunk = chunks[i / CHUNK_SIZE];
+
+        // Copy the chunk before writing to it if anything else still references it.
+        if (references[chunk] > 1) {
+            const std::uint32_t copy = allocate_chunk();
+            std::memcpy(&chunk_characters[copy * CHUNK_SIZE], &chunk_characters[chunk * CHUNK_SIZE], CHUNK_SIZE);
+            references[copy] = 1;
+            release_chunk(chunk);
+            chunk = copy;
+        }
+
+        char &c = chunk_characters[chunk * CHUNK_SIZE + i % CHUNK_SIZE];
+        const char mutation = mutated_char(c, random, evolution_settings.fitness_mode);
+        errors[individual] += error_delta(target[i], c, mutation, evolution_settings.fitness_mode);
+        c = mutation;
+
+    }
+
+}
+
+
+void ChunkedEvolution::refill_individual(const std::size_t individual) {
+
+    std::uint32_t *chunks = genome(individual);
+
+    for (std::size_t c = 0; c < chunks_per_genome; c++) {
+        if (chunks[c] != elite_chunks[c]) {
+            references[elite_chunks[c]]++;
+            release_chunk(chunks[c]);
+            chunks[c] = elite_chunks[c];
+        }
+    }
+
+}
+
+
+Evolution::Generation ChunkedEvolution::step() {
+
+    generation++;
+
+    {
+        const TraceScope scope("mutation");
+        for (std::size_t i = 0; i < population_size; i++) {
+            mutate_individual(i);
+        }
+    }
+
+    std::size_t highest_scorer;
+    {
+        const TraceScope scope("selection");
+        highest_scorer = highest_scoring(errors);
+    }
+
+    // The elite takes its own references to the chunks of the highest scorer, which keeps them alive during the
+    // refill, and copies their characters out for printing.
+    const std::uint32_t *chunks = genome(highest_scorer);
+    const std::size_t length = evolution_settings.target.length();
+    for (std::size_t c = 0; c < chunks_per_genome; c++) {
+        references[chunks[c]]++;
+        release_chunk(elite_chunks[c]);
+        elite_chunks[c] = chunks[c];
+        std::memcpy(&elite[c * CHUNK_SIZE], &chunk_characters[chunks[c] * CHUNK_SIZE],
+                    std::min(CHUNK_SIZE, length - c * CHUNK_SIZE));
+    }
+
+    const long elite_error = errors[highest_scorer];
+    const double score = fitness(elite_error, length, evolution_settings.fitness_mode);
+    const bool solved = elite_error == 0;
+
+    // Share the elite's chunks with every individual.
+    if (!solved) {
+        const TraceScope scope("refill");
+        for (std::size_t i = 0; i < population_size; i++) {
+            refill_individual(i);
+            errors[i] = elite_error;
+        }
+    }
+
+    return {generation, elite_error, score, solved};
+
+}
@@ -0,0 +1,122 @@
+#ifndef CHUNKED_H
+#define CHUNKED_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "engine.h"
+
+
+/// How many characters each chunk of a genome holds.
+static constexpr std::size_t CHUNK_SIZE = 32;
+
+/**
+ * Evolves a population like {@link Evolution}, but stores each genome as a list of reference-counted chunks instead of
+ * a copy of every character. Copying a genome only copies its chunk references, and a chunk is only copied when an
+ * individual that shares it mutates it. As mutation touches few characters, most chunks stay shared with the elite
+ * from one generation to the next.
+ *
+ * The error of every individual is updated by each mutation as it happens, so the rest of the genome is never visited
+ * to score it.
+ *
+ * Mutation always skips straight to the characters that mutate, like {@link mutate_sparse}, so that chunks without
+ * mutations are never touched. Evolutions run on the calling thread, and use the built-in fitness function.
+ */
+class ChunkedEvolution {
+
+public:
+
+    /**
+     * @param settings The settings of the evolution.
+     * @param population_size How many individuals the population is comprised of.
+     * @param seed The seed of the random number generator.
+     */
+    ChunkedEvolution(EvolutionSettings settings, std::size_t population_size, std::uint64_t seed);
+
+    /**
+     * Replaces every individual with the same individual, sharing all of its chunks, and restarts the generation
+     * count.
+     *
+     * @param individual The individual to copy.
+     */
+    void reset(std::string_view individual);
+
+    /**
+     * Runs a single generation. Unless the target was reached, every individual is replaced with the individual that
+     * had the peak fitness score.
+     *
+     * @return The outcome of the generation.
+     */
+    Evolution::Generation step();
+
+    /**
+     * @return The individual with the peak fitness score in the latest generation.
+     */
+    [[nodiscard]] std::string_view best() const {
+        return elite;
+    }
+
+    /**
+     * @return How many chunks are referenced by at least one individual.
+     */
+    [[nodiscard]] std::size_t live_chunks() const {
+        return references.size() - free_chunks.size();
+    }
+
+    /**
+     * @return How many chunks have been allocated, including those waiting to be reused.
+     */
+    [[nodiscard]] std::size_t allocated_chunks() const {
+        return references.size();
+    }
+
+private:
+
+    /// Takes a chunk with no references from the free list, or allocates a new one.
+    std::uint32_t allocate_chunk();
+
+    /// Drops a reference to a chunk, returning it to the free list once nothing references it.
+    void release_chunk(std::uint32_t chunk);
+
+    /// Finds the chunk references of an individual.
+    std::uint32_t *genome(std::size_t individual) {
+        return genomes.data() + individual * chunks_per_genome;
+    }
+
+    /// Mutates an individual, copying each shared chunk before the first mutation within it.
+    void mutate_individual(std::size_t individual);
+
+    /// Replaces an individual's chunk references with the elite's.
+    void refill_individual(std::size_t individual);
+
+    EvolutionSettings evolution_settings;
+    std::size_t population_size;
+    std::size_t chunks_per_genome;
+    Random random;
+
+    /// The characters of every chunk, CHUNK_SIZE at a time.
+    std::vector<char> chunk_characters;
+
+    /// How many individuals reference each chunk, where the elite counts as one.
+    std::vector<std::uint32_t> references;
+
+    /// The chunks without references, which are reused before any new ones are allocated.
+    std::vector<std::uint32_t> free_chunks;
+
+    /// The chunk references of every individual, back to back.
+    std::vector<std::uint32_t> genomes;
+
+    /// The error of each individual, which is kept up to date as the individual mutates.
+    std::vector<long> errors;
+
+    /// The chunk references of the individual with the peak fitness score, and a copy of its characters.
+    std::vector<std::uint32_t> elite_chunks;
+    std::string elite;
+
+    int generation = 0;
+
+};
+
+#endif
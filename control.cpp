@@ -0,0 +1,152 @@
+#include "control.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include "threads.h"
+
+
+namespace {
+
+    /**
+     * Parses a whole number, with nothing after it.
+     */
+    bool parse_count(const std::string &text, std::size_t &count) {
+
+        if (text.empty() || text[0] == '-') {
+            return false;
+        }
+
+        char *end = nullptr;
+        errno = 0;
+        const unsigned long long value = std::strtoull(text.c_str(), &end, 10);
+        if (errno != 0 || *end != '\0') {
+            return false;
+        }
+
+        count = static_cast<std::size_t>(value);
+        return true;
+
+    }
+
+}
+
+
+ControlChannel::~ControlChannel() {
+
+    if (descriptor >= 0) {
+        close(descriptor);
+    }
+
+}
+
+
+std::string ControlChannel::open(const std::string &file_path) {
+
+    const std::size_t slash = file_path.find_last_of('/');
+    const std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : file_path.substr(0, slash);
+    name = slash == std::string::npos ? file_path : file_path.substr(slash + 1);
+    path = file_path;
+
+    descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (descriptor < 0) {
+        return std::string("could not start watching: ") + std::strerror(errno);
+    }
+
+    // Editors either rewrite a file in place or rename a new one over it, which end in these events respectively.
+    if (inotify_add_watch(descriptor, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        const std::string message = directory + ": " + std::strerror(errno);
+        close(descriptor);
+        descriptor = -1;
+        return message;
+    }
+
+    return "";
+
+}
+
+
+bool ControlChannel::changed() {
+
+    if (descriptor < 0) {
+        return false;
+    }
+
+    // Drain every pending event, as several may have queued up since the last check.
+    bool seen = false;
+    alignas(inotify_event) char buffer[4096];
+    for (;;) {
+
+        const ssize_t length = ::read(descriptor, buffer, sizeof(buffer));
+        if (length <= 0) {
+            return seen;
+        }
+
+        for (ssize_t offset = 0; offset < length;) {
+            const auto *event = reinterpret_cast<const inotify_event *>(buffer + offset);
+            seen = seen || (event->len > 0 && name == event->name);
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+        }
+
+    }
+
+}
+
+
+std::string ControlChannel::read(ControlChanges &changes) const {
+
+    std::ifstream file(path);
+    if (!file) {
+        return "could not open " + path;
+    }
+
+    ControlChanges parsed;
+    std::string line;
+    for (int number = 1; std::getline(file, line); number++) {
+
+        std::istringstream stream(line);
+        std::string setting;
+        std::string value;
+        if (!(stream >> setting) || setting[0] == '#') {
+            continue;
+        }
+
+        const std::string where = path + ":" + std::to_string(number) + ": ";
+        std::string rest;
+        if (!(stream >> value) || stream >> rest) {
+            return where + setting + " needs exactly one value";
+        }
+
+        std::size_t count = 0;
+        if (setting == "mutation-chance") {
+            char *end = nullptr;
+            const double chance = std::strtod(value.c_str(), &end);
+            if (*end != '\0' || !(chance >= 0 && chance <= 1)) {
+                return where + "the mutation chance must be within [0, 1]";
+            }
+            parsed.mutation_chance = chance;
+        } else if (setting == "threads" && parse_count(value, count)) {
+            if (const std::size_t limit = thread_limit(detect_topology()); count > limit) {
+                return where + "the thread count must be at most " + std::to_string(limit);
+            }
+            parsed.threads = count;
+        } else if (setting == "quiet" && (value == "0" || value == "1")) {
+            parsed.quiet = value == "1";
+        } else if (setting == "log-interval" && parse_count(value, count) && count > 0) {
+            parsed.log_interval = count;
+        } else {
+            return where + "unknown setting or invalid value: " + line;
+        }
+
+    }
+
+    changes = parsed;
+    return "";
+
+}
@@ -0,0 +1,88 @@
+#ifndef CONTROL_H
+#define CONTROL_H
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+
+/**
+ * The settings that a control file changes, where each is only present if the file sets it.
+ */
+struct ControlChanges {
+
+    /// The chance for each value to mutate.
+    std::optional<double> mutation_chance;
+
+    /// How many workers evolve the population, where 0 is one per CPU.
+    std::optional<std::size_t> threads;
+
+    /// If the individual with the peak fitness score should be left out of the output.
+    std::optional<bool> quiet;
+
+    /// How many generations pass between each one that is printed.
+    std::optional<std::size_t> log_interval;
+
+};
+
+
+/**
+ * Watches a control file with inotify, so that a run can be tuned while it is live without polling the file system.
+ * The file holds one setting per line as a name and a value, such as "mutation-chance 0.02", and lines starting with
+ * '#' are ignored. The settings are:
+ *
+ * - mutation-chance <chance>
+ * - threads <count>, at most {@link thread_limit}
+ * - quiet <0|1>
+ * - log-interval <generations>
+ *
+ * The directory is watched rather than the file, so that the file can be replaced by an editor or by renaming another
+ * over it. Only changes made once the channel is open are seen.
+ */
+class ControlChannel {
+
+public:
+
+    ControlChannel() = default;
+    ControlChannel(const ControlChannel &) = delete;
+    ControlChannel &operator=(const ControlChannel &) = delete;
+    ~ControlChannel();
+
+    /**
+     * Starts watching a control file, which does not have to exist yet.
+     *
+     * @param path The path of the file.
+     *
+     * @return An empty string on success, otherwise a description of the error.
+     */
+    std::string open(const std::string &path);
+
+    /**
+     * Checks if the file has been written to since the last check, without blocking. This costs a single system call
+     * when it has not, and nothing when the channel is not open.
+     *
+     * @return If the file has changed.
+     */
+    bool changed();
+
+    /**
+     * Reads the settings in the file.
+     *
+     * @param changes The settings, which are only written to if the whole file was read.
+     *
+     * @return An empty string on success, otherwise a description of the error.
+     */
+    [[nodiscard]] std::string read(ControlChanges &changes) const;
+
+private:
+
+    std::string path;
+
+    /// The name of the file within its directory, which events are matched against.
+    std::string name;
+
+    int descriptor = -1;
+
+};
+
+#endif
@@ -0,0 +1,225 @@
+#include "dashboard.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+
+namespace {
+
+    /// Moves the cursor to the top left, and clears the rest of a line or of the screen.
+    constexpr const char *HOME = "\x1b[H";
+    constexpr const char *CLEAR_LINE = "\x1b[K";
+    constexpr const char *CLEAR_BELOW = "\x1b[J";
+
+    constexpr const char *MATCH = "\x1b[32m";
+    constexpr const char *MISMATCH = "\x1b[31m";
+    constexpr const char *RESET = "\x1b[0m";
+
+    /// The blocks of the fitness curve, from lowest to highest.
+    constexpr const char *BLOCKS[] = {"▁", "▂", "▃", "▄", "▅", "▆", "▇", "█"};
+
+    /// How wide the bar of each worker's busy time is.
+    constexpr std::size_t BAR_WIDTH = 30;
+
+    /// The most workers that are shown.
+    constexpr std::size_t MAX_WORKERS = 16;
+
+    /**
+     * @return The width of the terminal, or 80 columns if it is not a terminal.
+     */
+    std::size_t terminal_width() {
+
+        winsize size{};
+        if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) != 0 || size.ws_col == 0) {
+            return 80;
+        }
+
+        return size.ws_col;
+
+    }
+
+    /**
+     * Writes a whole frame to the standard output at once.
+     */
+    void write_out(const std::string &text) {
+
+        std::fwrite(text.data(), 1, text.size(), stdout);
+        std::fflush(stdout);
+
+    }
+
+}
+
+
+Dashboard::~Dashboard() {
+    stop();
+}
+
+
+void Dashboard::start() {
+
+    if (running.exchange(true)) {
+        return;
+    }
+
+    // Hide the cursor and clear the screen, so that every frame is drawn over the last.
+    started = std::chrono::steady_clock::now();
+    write_out("\x1b[?25l\x1b[2J");
+    drawer = std::thread(&Dashboard::draw_loop, this);
+
+}
+
+
+void Dashboard::stop() {
+
+    if (!running.exchange(false)) {
+        return;
+    }
+
+    drawer.join();
+    write_out("\x1b[?25h");
+
+}
+
+
+void Dashboard::on_termination(const GenerationView &view, std::chrono::nanoseconds) {
+
+    if (!running.exchange(false)) {
+        return;
+    }
+
+    // With the drawing thread stopped, this thread can take the last snapshot and draw it itself.
+    drawer.join();
+    Snapshot previous = std::move(snapshot);
+    take_snapshot(view);
+    draw(snapshot, previous);
+    write_out("\x1b[?25h");
+
+}
+
+
+void Dashboard::take_snapshot(const GenerationView &view) {
+
+    snapshot.generation = view.result.number;
+    snapshot.error = view.result.error;
+    snapshot.score = view.result.score;
+    snapshot.solved = view.result.solved;
+    snapshot.best.assign(view.best.data(), view.best.size());
+    snapshot.taken = std::chrono::steady_clock::now();
+
+    snapshot.busy.clear();
+    for (std::size_t worker = 0; pool != nullptr && worker < pool->size(); worker++) {
+        snapshot.busy.push_back(pool->busy_time(worker));
+    }
+
+}
+
+
+void Dashboard::draw_loop() {
+
+    Snapshot current;
+    Snapshot previous;
+    previous.taken = started;
+
+    requested.store(true, std::memory_order_release);
+    while (running.load(std::memory_order_relaxed)) {
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1000 / REFRESH_RATE));
+
+        // A generation that takes longer than a frame leaves the last frame up until it ends.
+        if (!ready.load(std::memory_order_acquire)) {
+            continue;
+        }
+
+        std::swap(current, snapshot);
+        ready.store(false, std::memory_order_relaxed);
+        requested.store(true, std::memory_order_release);
+
+        draw(current, previous);
+        std::swap(previous, current);
+
+    }
+
+    // Hand the last snapshot back, so that the final frame is measured against it.
+    if (!ready.load(std::memory_order_acquire)) {
+        snapshot = std::move(previous);
+    }
+    requested.store(false, std::memory_order_relaxed);
+    ready.store(false, std::memory_order_relaxed);
+
+}
+
+
+void Dashboard::draw(const Snapshot &current, const Snapshot &previous) {
+
+    const std::size_t width = std::max<std::size_t>(terminal_width(), 20);
+    const double seconds = std::chrono::duration<double>(current.taken - previous.taken).count();
+    const double elapsed = std::chrono::duration<double>(current.taken - started).count();
+
+    std::ostringstream frame;
+    frame << HOME << std::fixed;
+
+    frame << "Generation " << current.generation << "   Score " << std::setprecision(6) << current.score
+          << "   Error " << current.error << "   " << std::setprecision(0)
+          << (seconds > 0 ? (current.generation - previous.generation) / seconds : 0) << " generations/s   "
+          << std::setprecision(1) << elapsed << "s" << (current.solved ? "   Solved" : "") << CLEAR_LINE << '\n'
+          << CLEAR_LINE << '\n';
+
+    // The best individual, wrapped to the terminal, with characters that are not printable shown as dots.
+    frame << "Best" << CLEAR_LINE << '\n';
+    const std::size_t lines = std::min((current.best.size() + width - 1) / width, MAX_INDIVIDUAL_LINES);
+    for (std::size_t line = 0; line < lines; line++) {
+
+        const char *colour = nullptr;
+        for (std::size_t i = line * width; i < std::min((line + 1) * width, current.best.size()); i++) {
+            const char *wanted = i < target.size() && current.best[i] == target[i] ? MATCH : MISMATCH;
+            if (wanted != colour) {
+                frame << wanted;
+                colour = wanted;
+            }
+            const char c = current.best[i];
+            frame << (c >= ' ' && c < 127 ? c : '.');
+        }
+        frame << RESET << CLEAR_LINE << '\n';
+
+    }
+    frame << CLEAR_LINE << '\n';
+
+    // The peak fitness score of each frame, scaled between the lowest and highest that are shown.
+    history.push_back(current.score);
+    if (history.size() > width) {
+        history.erase(history.begin(), history.end() - static_cast<std::ptrdiff_t>(width));
+    }
+    const auto [lowest, highest] = std::minmax_element(history.begin(), history.end());
+    frame << "Fitness " << std::setprecision(6) << *lowest << " to " << *highest << CLEAR_LINE << '\n';
+    for (const double score : history) {
+        const double height = *highest > *lowest ? (score - *lowest) / (*highest - *lowest) : 0;
+        frame << BLOCKS[std::min<std::size_t>(static_cast<std::size_t>(height * 8), 7)];
+    }
+    frame << CLEAR_LINE << '\n' << CLEAR_LINE << '\n';
+
+    // How much of the time since the last frame each worker spent running tasks.
+    frame << "Workers" << CLEAR_LINE << '\n';
+    for (std::size_t worker = 0; worker < std::min(current.busy.size(), MAX_WORKERS); worker++) {
+
+        const bool comparable = previous.busy.size() == current.busy.size() && seconds > 0;
+        const double busy = comparable
+                            ? std::chrono::duration<double>(current.busy[worker] - previous.busy[worker]).count()
+                            : 0;
+        const double utilization = std::clamp(comparable ? busy / seconds : 0.0, 0.0, 1.0);
+        const auto filled = static_cast<std::size_t>(utilization * BAR_WIDTH + 0.5);
+
+        frame << std::setw(3) << worker << " [" << std::string(filled, '#') << std::string(BAR_WIDTH - filled, ' ')
+              << "] " << std::setw(3) << std::setprecision(0) << utilization * 100 << '%' << CLEAR_LINE << '\n';
+
+    }
+    frame << CLEAR_BELOW;
+
+    write_out(frame.str());
+
+}
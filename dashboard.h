@@ -0,0 +1,115 @@
+#ifndef DASHBOARD_H
+#define DASHBOARD_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "observer.h"
+#include "threads.h"
+
+
+/**
+ * A terminal dashboard which redraws a fixed number of times per second with ANSI escape codes, in place of a line per
+ * generation. It shows the best individual with the characters that match the target highlighted, a curve of the peak
+ * fitness score, the generations per second and how busy each worker is.
+ *
+ * Drawing happens on a thread of its own, so the generation loop never waits for the terminal. The two only meet
+ * through a snapshot, which the drawing thread asks for and the generation loop fills in at the end of its next
+ * generation, without either ever taking a lock. Until it is started, the dashboard costs a single atomic load per
+ * generation.
+ */
+class Dashboard final : public GenerationObserver {
+
+public:
+
+    /// How many times the dashboard is redrawn each second.
+    static constexpr int REFRESH_RATE = 10;
+
+    /// The most lines of the best individual that are shown.
+    static constexpr std::size_t MAX_INDIVIDUAL_LINES = 8;
+
+    /**
+     * @param target The target of the evolution, which the best individual is compared against.
+     */
+    explicit Dashboard(std::string target) : target(std::move(target)) {}
+
+    Dashboard(const Dashboard &) = delete;
+    Dashboard &operator=(const Dashboard &) = delete;
+    ~Dashboard() override;
+
+    /**
+     * Starts drawing to the standard output, replacing whatever the terminal shows.
+     */
+    void start();
+
+    /**
+     * Draws the last snapshot one final time, and stops drawing.
+     */
+    void stop();
+
+    /**
+     * Sets the workers whose busy time is shown, which must be called on the thread running the generation loop.
+     *
+     * @param workers The workers, which must be measuring their busy time, or nullptr to show none.
+     */
+    void watch(const WorkerPool *workers) {
+        pool = workers;
+    }
+
+    void on_generation(const GenerationView &view) override {
+
+        // The acquire orders this after the drawing thread is done with the previous snapshot.
+        if (requested.load(std::memory_order_acquire)) {
+            take_snapshot(view);
+            requested.store(false, std::memory_order_relaxed);
+            ready.store(true, std::memory_order_release);
+        }
+
+    }
+
+    void on_termination(const GenerationView &view, std::chrono::nanoseconds elapsed) override;
+
+private:
+
+    /// The state of the evolution at the end of a generation.
+    struct Snapshot {
+        int generation = 0;
+        long error = 0;
+        double score = 0;
+        bool solved = false;
+        std::string best;
+        std::chrono::steady_clock::time_point taken;
+        std::vector<std::chrono::nanoseconds> busy;
+    };
+
+    /// Fills in the snapshot from a generation.
+    void take_snapshot(const GenerationView &view);
+
+    /// The loop of the drawing thread.
+    void draw_loop();
+
+    /// Draws a snapshot, given the one drawn before it.
+    void draw(const Snapshot &current, const Snapshot &previous);
+
+    const std::string target;
+    const WorkerPool *pool = nullptr;
+
+    /// The drawing thread sets requested, and then only reads the snapshot once the generation loop sets ready.
+    alignas(64) std::atomic<bool> requested{false};
+    alignas(64) std::atomic<bool> ready{false};
+    Snapshot snapshot;
+
+    /// The peak fitness score of every frame drawn, and when the dashboard started.
+    std::vector<double> history;
+    std::chrono::steady_clock::time_point started;
+
+    std::atomic<bool> running{false};
+    std::thread drawer;
+
+};
+
+#endif
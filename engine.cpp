@@ -0,0 +1,305 @@
+#include "engine.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+
+#include "trace.h"
+
+
+char mutated_char(const char c, Random &random, const FitnessMode mode) {
+
+    if (mode != FitnessMode::GRADED) {
+        return static_cast<char>(random.below(CHAR_MAX));
+    }
+
+    // Pick a non-zero step within [-GRADED_STEP, GRADED_STEP], and keep the result within [0, CHAR_MAX).
+    const int step = static_cast<int>(random.below(GRADED_STEP)) + 1;
+    const int value = static_cast<unsigned char>(c) + (random.below(2) == 0 ? step : -step);
+
+    return static_cast<char>(std::clamp(value, 0, CHAR_MAX - 1));
+
+}
+
+
+std::string starting_individual(const std::size_t length, const std::uint64_t seed) {
+
+    Random random(stream_seed(seed, StreamPurpose::START));
+    std::string start(length, 0);
+    for (char &c : start) {
+        c = static_cast<char>(random.below(CHAR_MAX));
+    }
+
+    return start;
+
+}
+
+
+long error(const std::string_view individual, const std::string_view target, const FitnessMode mode) {
+
+    const auto *values = reinterpret_cast<const unsigned char *>(individual.data());
+    const auto *targets = reinterpret_cast<const unsigned char *>(target.data());
+    const std::size_t length = individual.length();
+
+    // Both loops are kept branch-free so the compiler can vectorize them.
+    std::int64_t total = 0;
+    if (mode == FitnessMode::GRADED) {
+        for (std::size_t i = 0; i < length; i++) {
+            total += std::abs(static_cast<int>(values[i]) - static_cast<int>(targets[i]));
+        }
+    } else {
+        for (std::size_t i = 0; i < length; i++) {
+            total += values[i] != targets[i];
+        }
+    }
+
+    return static_cast<long>(total);
+
+}
+
+
+long error_delta(const char target, const char before, const char after, const FitnessMode mode) {
+
+    const int goal = static_cast<unsigned char>(target);
+
+    if (mode == FitnessMode::GRADED) {
+        return std::abs(static_cast<unsigned char>(after) - goal) - std::abs(static_cast<unsigned char>(before) - goal);
+    }
+
+    return (static_cast<unsigned char>(after) != goal) - (static_cast<unsigned char>(before) != goal);
+
+}
+
+
+double fitness(const long error, const std::size_t length, const FitnessMode mode) {
+
+    // The largest error a single character can contribute.
+    const double worst = mode == FitnessMode::GRADED ? UCHAR_MAX : 1;
+
+    return 1.0 - static_cast<double>(error) / (worst * static_cast<double>(length));
+
+}
+
+
+int mutate(char *individual, long &error, Random &random, const EvolutionSettings &settings) {
+
+    int mutations = 0;
+
+    for (std::size_t i = 0; i < settings.target.length(); i++) {
+
+        if (settings.mutation_chance >= random.chance()) {
+
+            const char mutation = mutated_char(individual[i], random, settings.fitness_mode);
+
+            error += error_delta(settings.target[i], individual[i], mutation, settings.fitness_mode);
+            individual[i] = mutation;
+
+            mutations++;
+
+        }
+
+    }
+
+    return mutations;
+
+}
+
+
+int mutate_sparse(char *individual, long &error, Random &random, const EvolutionSettings &settings) {
+
+    // A chance of 0 never mutates, and would otherwise divide by 0.
+    const double log_keep = std::log1p(-settings.mutation_chance);
+    if (!(log_keep < 0)) {
+        return 0;
+    }
+
+    // Draws how many characters are left alone before the next one mutates. A tiny chance can draw a gap too large for
+    // a std::size_t, so gaps are capped at the length first.
+    const auto length = static_cast<double>(settings.target.length());
+    const auto gap = [&]() {
+        return static_cast<std::size_t>(std::min(std::log(1.0 - random.chance()) / log_keep, length));
+    };
+
+    int mutations = 0;
+
+    for (std::size_t i = gap(); i < settings.target.length(); i += gap() + 1) {
+
+        const char mutation = mutated_char(individual[i], random, settings.fitness_mode);
+
+        error += error_delta(settings.target[i], individual[i], mutation, settings.fitness_mode);
+        individual[i] = mutation;
+
+        mutations++;
+
+    }
+
+    return mutations;
+
+}
+
+
+std::size_t highest_scoring(const std::vector<long> &errors) {
+    return static_cast<std::size_t>(std::min_element(errors.begin(), errors.end()) - errors.begin());
+}
+
+
+Evolution::Evolution(EvolutionSettings settings, Population &population, WorkerPool &pool,
+                     BatchFitness *batch_fitness, const std::uint64_t seed)
+        : evolution_settings(std::move(settings)), population(population), pool(&pool), batch_fitness(batch_fitness),
+          randoms(pool.size()), errors(population.size()) {
+
+    for (std::size_t worker = 0; worker < randoms.size(); worker++) {
+        randoms[worker].random.reseed(stream_seed(seed, StreamPurpose::MUTATION, worker));
+    }
+
+    elite.reserve(evolution_settings.target.length());
+
+}
+
+
+void Evolution::reset(const std::string_view individual) {
+
+    elite = individual;
+    refill_population(error(individual, evolution_settings.target, evolution_settings.fitness_mode));
+    generation = 0;
+
+}
+
+
+void Evolution::rebind(WorkerPool &workers) {
+
+    // Workers that are kept carry on with their own streams, and new ones are seeded from the first worker's stream.
+    const std::size_t kept = std::min(randoms.size(), workers.size());
+    randoms.resize(workers.size());
+    for (std::size_t worker = kept; worker < randoms.size(); worker++) {
+        randoms[worker].random.reseed(stream_seed(randoms[0].random.next(), StreamPurpose::MUTATION, worker));
+    }
+
+    pool = &workers;
+
+}
+
+
+void Evolution::record_lineage(LineageLog *log) {
+
+    lineage = log;
+    mutation_counts.assign(log != nullptr ? population.size() : 0, 0);
+    error_deltas.assign(log != nullptr ? population.size() : 0, 0);
+
+}
+
+
+void Evolution::restart() {
+
+    pool->run([&](const std::size_t worker) {
+        const std::size_t end = slice_begin(worker + 1);
+        for (std::size_t i = slice_begin(worker); i < end; i++) {
+            errors[i] = error(population.view(i), evolution_settings.target, evolution_settings.fitness_mode);
+        }
+    });
+
+    // An empty population, as is left when genomes are kept elsewhere, has no elite.
+    if (!errors.empty()) {
+        elite = population.view(highest_scoring(errors));
+    }
+    generation = 0;
+
+}
+
+
+std::size_t Evolution::slice_begin(const std::size_t worker) const {
+    return population.size() * worker / pool->size();
+}
+
+
+void Evolution::mutate_population() {
+
+    pool->run([&](const std::size_t worker) {
+
+        const TraceScope scope("mutation");
+        const std::size_t end = slice_begin(worker + 1);
+        Random &random = randoms[worker].random;
+
+        for (std::size_t i = slice_begin(worker); i < end; i++) {
+
+            const long before = errors[i];
+            const int mutations = evolution_settings.sparse
+                                  ? mutate_sparse(population[i], errors[i], random, evolution_settings)
+                                  : mutate(population[i], errors[i], random, evolution_settings);
+
+            if (lineage != nullptr) {
+                mutation_counts[i] = static_cast<std::uint16_t>(std::min(mutations, UINT16_MAX));
+                error_deltas[i] = static_cast<std::int32_t>(errors[i] - before);
+            }
+
+        }
+
+    });
+
+}
+
+
+void Evolution::refill_population(const long elite_error) {
+
+    pool->run([&](const std::size_t worker) {
+
+        const TraceScope scope("refill");
+        const std::size_t begin = slice_begin(worker);
+        const std::size_t end = slice_begin(worker + 1);
+
+        population.fill(elite, begin, end);
+        std::fill(errors.begin() + static_cast<std::ptrdiff_t>(begin), errors.begin() + static_cast<std::ptrdiff_t>(end),
+                  elite_error);
+
+    });
+
+}
+
+
+Evolution::Generation Evolution::step() {
+
+    generation++;
+
+    // Attempt to mutate each individual in the population.
+    mutate_population();
+
+    // Get the individual with the highest score. A batch fitness function scores the whole population, while the
+    // built-in fitness function relies on the errors that were updated during mutation.
+    std::size_t highest_scorer;
+    if (batch_fitness != nullptr) {
+        {
+            const TraceScope scope("evaluation");
+            batch_fitness->evaluate(population, evolution_settings.target, scores);
+        }
+        const TraceScope scope("selection");
+        highest_scorer = static_cast<std::size_t>(std::max_element(scores.begin(), scores.end()) - scores.begin());
+    } else {
+        const TraceScope scope("selection");
+        highest_scorer = highest_scoring(errors);
+    }
+
+    elite = population.view(highest_scorer);
+
+    const long elite_error = errors[highest_scorer];
+    const double score = batch_fitness != nullptr
+                         ? scores[highest_scorer]
+                         : fitness(elite_error, elite.length(), evolution_settings.fitness_mode);
+    const bool solved = batch_fitness != nullptr ? score >= 1 : elite_error == 0;
+
+    // Every offspring of the first generation descends from the individual it replaced, and every later one from the
+    // previous elite.
+    if (lineage != nullptr) {
+        lineage->record(generation, generation == 1 ? -1 : static_cast<long>(parent), highest_scorer, mutation_counts,
+                        error_deltas);
+        parent = highest_scorer;
+    }
+
+    // Replace each individual with the peak individual.
+    if (!solved) {
+        refill_population(elite_error);
+    }
+
+    return {generation, elite_error, score, solved};
+
+}
@@ -0,0 +1,301 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "batch_fitness.h"
+#include "lineage.h"
+#include "population.h"
+#include "random.h"
+#include "threads.h"
+
+
+/// The ways in which an individual can be scored against the target.
+enum class FitnessMode {
+
+    /// Only characters that exactly match the target are rewarded.
+    EXACT,
+
+    /// Every character is rewarded by how close its value is to the target's, giving the search a gradient to follow.
+    GRADED
+
+};
+
+/// The largest step a character can take when it is nudged by a mutation in graded mode.
+static constexpr int GRADED_STEP = 8;
+
+/**
+ * The settings of an evolution.
+ */
+struct EvolutionSettings {
+
+    /// The target value for the mutations.
+    std::string target;
+
+    /// The chance for each value to mutate.
+    double mutation_chance = 0.01;
+
+    /// The mode used to score individuals.
+    FitnessMode fitness_mode = FitnessMode::EXACT;
+
+    /// If mutation skips straight to the characters that mutate, using {@link mutate_sparse}.
+    bool sparse = false;
+
+};
+
+
+/**
+ * Calculates how far a string is from the target. Exact mode counts the mismatched characters, while graded mode sums
+ * the absolute difference between each character and the target's.
+ *
+ * @param individual The string to compare to the target.
+ * @param target The target, which must be as long as the string.
+ * @param mode The mode used to score the string.
+ *
+ * @return The error of the string, where 0 means the string is the target.
+ */
+long error(std::string_view individual, std::string_view target, FitnessMode mode);
+
+/**
+ * Calculates the change in error caused by replacing a single character, so that point mutations can be scored in
+ * constant time instead of re-evaluating the whole string.
+ *
+ * @param target The target's character at the position that was replaced.
+ * @param before The character before the replacement.
+ * @param after The character after the replacement.
+ * @param mode The mode used to score the string.
+ *
+ * @return The amount to add to the error of the string.
+ */
+long error_delta(char target, char before, char after, FitnessMode mode);
+
+/**
+ * Converts an error into a fitness score.
+ *
+ * @param error The error of the string, as given by {@link error}.
+ * @param length The length of the string.
+ * @param mode The mode used to score the string.
+ *
+ * @return The fitness score within [0, 1], where 1 means the string is the target.
+ */
+double fitness(long error, std::size_t length, FitnessMode mode);
+
+/**
+ * Selects the value a character mutates into. In graded mode characters are nudged towards a nearby value, so that the
+ * gradient of the fitness score can be followed, otherwise a new character is chosen at random.
+ *
+ * @param c The character that is mutating.
+ * @param random The random number generator to use.
+ * @param mode The mode used to score individuals.
+ *
+ * @return The mutated character.
+ */
+char mutated_char(char c, Random &random, FitnessMode mode);
+
+/**
+ * Draws the starting individual of a run from its seed. Every character is drawn from [0, CHAR_MAX), like the
+ * characters of mutations, so that runs search the same space wherever they start.
+ *
+ * @param length The length of the individual.
+ * @param seed The seed of the run.
+ *
+ * @return The individual.
+ */
+std::string starting_individual(std::size_t length, std::uint64_t seed);
+
+/**
+ * Attempts to mutate characters within an individual, while keeping its error up to date.
+ *
+ * @param individual The individual to mutate, which is as long as the target.
+ * @param error The error of the individual, which is updated for every mutation.
+ * @param random The random number generator to use.
+ * @param settings The settings of the evolution.
+ *
+ * @return The amount of mutations that occurred.
+ */
+int mutate(char *individual, long &error, Random &random, const EvolutionSettings &settings);
+
+/**
+ * Mutates an individual like {@link mutate}, but skips straight to the next character that mutates instead of drawing
+ * a random number for every character. The gaps between mutations follow a geometric distribution, so the outcome is
+ * the same while far fewer random numbers are drawn when the mutation chance is small.
+ */
+int mutate_sparse(char *individual, long &error, Random &random, const EvolutionSettings &settings);
+
+/**
+ * Finds the highest scoring individual in a population from the errors of its individuals.
+ *
+ * @param errors The error of each individual in the population.
+ *
+ * @return The index of the individual with the lowest error.
+ */
+std::size_t highest_scoring(const std::vector<long> &errors);
+
+
+/**
+ * Evolves a population towards a target. Every generation mutates each individual, selects the individual with the
+ * peak fitness score, and replaces every individual with it.
+ */
+class Evolution {
+
+public:
+
+    /**
+     * The outcome of a single generation.
+     */
+    struct Generation {
+
+        /// The number of the generation, starting at 1.
+        int number;
+
+        /// The error of the individual with the peak fitness score.
+        long error;
+
+        /// The peak fitness score.
+        double score;
+
+        /// If the target has been reached, which ends the evolution.
+        bool solved;
+
+    };
+
+    /**
+     * @param settings The settings of the evolution.
+     * @param population The population to evolve, whose individuals must be as long as the target.
+     * @param pool The workers which mutate and refill the population, each owning a slice of it.
+     * @param batch_fitness A fitness function to use in place of the built-in one, if any.
+     * @param seed The seed of the random number generators, one per worker.
+     */
+    Evolution(EvolutionSettings settings, Population &population, WorkerPool &pool, BatchFitness *batch_fitness,
+              std::uint64_t seed);
+
+    /**
+     * Replaces every individual with a copy of the same individual, and restarts the generation count.
+     *
+     * @param individual The individual to copy.
+     */
+    void reset(std::string_view individual);
+
+    /**
+     * Restarts the generation count from the individuals already in the population, such as those written by an
+     * {@link Initializer}, scoring each of them.
+     */
+    void restart();
+
+    /**
+     * Moves the evolution onto a different pool of workers between generations, which may have a different size. The
+     * population is kept as it is, and is split between the new workers.
+     *
+     * @param workers The workers which mutate and refill the population from now on.
+     */
+    void rebind(WorkerPool &workers);
+
+    /**
+     * Records the parent, mutations and change in error of every offspring from the next generation on. Nothing is
+     * tracked unless a log is given.
+     *
+     * @param log The log to record into, or nullptr to stop recording.
+     */
+    void record_lineage(LineageLog *log);
+
+    /**
+     * Changes the chance for each value to mutate, from the next generation on.
+     *
+     * @param chance The new chance.
+     */
+    void set_mutation_chance(const double chance) {
+        evolution_settings.mutation_chance = chance;
+    }
+
+    /**
+     * Runs a single generation. Unless the target was reached, every individual is replaced with the individual that
+     * had the peak fitness score.
+     *
+     * @return The outcome of the generation.
+     */
+    Generation step();
+
+    /**
+     * @return The individual with the peak fitness score in the latest generation.
+     */
+    [[nodiscard]] std::string_view best() const {
+        return elite;
+    }
+
+    /**
+     * @return The settings of the evolution.
+     */
+    [[nodiscard]] const EvolutionSettings &settings() const {
+        return evolution_settings;
+    }
+
+    /**
+     * @return The error of each individual, by its index in the population.
+     */
+    [[nodiscard]] const std::vector<long> &individual_errors() const {
+        return errors;
+    }
+
+    /**
+     * @return The score of each individual in the latest generation, which is only kept with a batch fitness function.
+     */
+    [[nodiscard]] const std::vector<double> &individual_scores() const {
+        return scores;
+    }
+
+    /**
+     * @return If scores come from a fitness function given in place of the built-in one.
+     */
+    [[nodiscard]] bool batch_scored() const {
+        return batch_fitness != nullptr;
+    }
+
+private:
+
+    /// A random number generator for a single worker, padded to a cache line so that workers do not contend over them.
+    struct alignas(64) WorkerRandom {
+        Random random;
+    };
+
+    /// Finds the first individual in a worker's slice, which is also the end of the previous worker's slice.
+    [[nodiscard]] std::size_t slice_begin(std::size_t worker) const;
+
+    /// Mutates every individual, with each worker mutating its own slice.
+    void mutate_population();
+
+    /// Replaces every individual with the elite, with each worker replacing its own slice.
+    void refill_population(long elite_error);
+
+    EvolutionSettings evolution_settings;
+    Population &population;
+    WorkerPool *pool;
+    BatchFitness *batch_fitness;
+
+    std::vector<WorkerRandom> randoms;
+
+    /// The error of each individual, which is kept up to date as the individuals mutate.
+    std::vector<long> errors;
+
+    /// The score of each individual, which is only used with a batch fitness function.
+    std::vector<double> scores;
+
+    /// A copy of the individual with the peak fitness score.
+    std::string elite;
+
+    /// The log of the lineage, if it is recorded, and how many characters each offspring mutated and how much that
+    /// changed its error, which are only kept while it is.
+    LineageLog *lineage = nullptr;
+    std::vector<std::uint16_t> mutation_counts;
+    std::vector<std::int32_t> error_deltas;
+
+    /// The index of the elite of the previous generation, which is the parent of every offspring.
+    std::size_t parent = 0;
+
+    int generation = 0;
+
+};
+
+#endif
@@ -0,0 +1,286 @@
+#include "expression.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cctype>
+#include <climits>
+#include <cstdlib>
+
+
+namespace {
+
+    /**
+     * A cursor over the source of an expression.
+     */
+    struct Parser {
+
+        const std::string &source;
+        std::size_t position = 0;
+
+        /// Skips any whitespace before the next token.
+        void skip() {
+            while (position < source.length() && std::isspace(static_cast<unsigned char>(source[position]))) {
+                position++;
+            }
+        }
+
+        /// Consumes a character if it is next, ignoring whitespace.
+        bool accept(const char c) {
+            skip();
+            if (position < source.length() && source[position] == c) {
+                position++;
+                return true;
+            }
+            return false;
+        }
+
+        /// Checks if the next characters are a given token, consuming them if they are.
+        bool accept(const std::string &token) {
+            skip();
+            if (source.compare(position, token.length(), token) == 0) {
+                position += token.length();
+                return true;
+            }
+            return false;
+        }
+
+        /// Reads a non-negative number, returning false and consuming nothing if there is none or it is malformed.
+        bool number(double &value) {
+            skip();
+            const std::size_t start = position;
+            while (position < source.length()
+                   && (std::isdigit(static_cast<unsigned char>(source[position])) || source[position] == '.')) {
+
+                // Stop before a range operator, so that '3..5' is read as 3 rather than as a malformed number.
+                if (source[position] == '.' && position + 1 < source.length() && source[position + 1] == '.') {
+                    break;
+                }
+                position++;
+            }
+            if (start == position) {
+                return false;
+            }
+
+            const std::string text = source.substr(start, position - start);
+            char *end = nullptr;
+            value = std::strtod(text.c_str(), &end);
+            if (end == text.c_str() || *end != '\0') {
+                position = start;
+                return false;
+            }
+            return true;
+        }
+
+        /// Reads a word made of letters, returning an empty string if there is none.
+        std::string word() {
+            skip();
+            const std::size_t start = position;
+            while (position < source.length() && std::isalpha(static_cast<unsigned char>(source[position]))) {
+                position++;
+            }
+            return source.substr(start, position - start);
+        }
+
+        /// Describes an error at the current position.
+        [[nodiscard]] std::string error(const std::string &message) const {
+            return "column " + std::to_string(position + 1) + ": " + message;
+        }
+
+    };
+
+    /// The named character classes, as tests on a single character.
+    struct CharacterClass {
+        const char *name;
+        int (*test)(int);
+    };
+
+    constexpr CharacterClass CLASSES[] = {
+            {"alpha", std::isalpha},
+            {"digit", std::isdigit},
+            {"space", std::isspace},
+            {"upper", std::isupper},
+            {"lower", std::islower},
+            {"punct", std::ispunct},
+            {"print", std::isprint}
+    };
+
+}
+
+
+std::string FitnessExpression::compile(const std::string &source, const std::string &target) {
+
+    const std::size_t length = target.length();
+
+    program.clear();
+    sets.clear();
+    total = 0;
+
+    Parser parser{source};
+
+    do {
+
+        Instruction instruction{Opcode::MATCH, 0, static_cast<std::uint32_t>(length), 1, 0};
+
+        // An optional weight, which must be followed by '*'.
+        if (parser.number(instruction.weight) && !parser.accept('*')) {
+            return parser.error("expected '*' after the weight");
+        }
+
+        // The predicate.
+        std::array<std::uint8_t, 256> set{};
+        if (parser.accept('[')) {
+
+            while (parser.position < source.length() && source[parser.position] != ']') {
+                set[static_cast<unsigned char>(source[parser.position++])] = 1;
+            }
+            if (!parser.accept(']')) {
+                return parser.error("expected ']' to close the set");
+            }
+            instruction.opcode = Opcode::SET;
+
+        } else if (parser.accept('\'')) {
+
+            if (parser.position + 1 >= source.length() || source[parser.position + 1] != '\'') {
+                return parser.error("expected a single quoted character");
+            }
+            set[static_cast<unsigned char>(source[parser.position])] = 1;
+            parser.position += 2;
+            instruction.opcode = Opcode::SET;
+
+        } else if (const std::string name = parser.word(); name != "match") {
+
+            const auto *found = std::find_if(std::begin(CLASSES), std::end(CLASSES), [&](const CharacterClass &c) {
+                return name == c.name;
+            });
+            if (found == std::end(CLASSES)) {
+                return parser.error(name.empty() ? "expected a predicate" : "unknown predicate '" + name + "'");
+            }
+            for (int c = 0; c < 256; c++) {
+                set[c] = found->test(c) != 0;
+            }
+            instruction.opcode = Opcode::SET;
+
+        }
+
+        if (instruction.opcode == Opcode::SET) {
+            instruction.set = static_cast<std::uint32_t>(sets.size());
+            sets.push_back(set);
+        }
+
+        // An optional position range.
+        if (parser.accept('@')) {
+
+            double begin;
+            if (!parser.number(begin)) {
+                return parser.error("expected a position after '@'");
+            }
+            double end = begin + 1;
+            if (parser.accept("..") && !parser.number(end)) {
+                return parser.error("expected a position after '..'");
+            }
+            if (begin >= end || end > static_cast<double>(length)) {
+                return parser.error("the range must be within [0, " + std::to_string(length) + ")");
+            }
+
+            instruction.begin = static_cast<std::uint32_t>(begin);
+            instruction.end = static_cast<std::uint32_t>(end);
+
+        }
+
+        total += instruction.weight * (instruction.end - instruction.begin);
+        program.push_back(instruction);
+
+    } while (parser.accept('+'));
+
+    parser.skip();
+    if (parser.position != source.length()) {
+        program.clear();
+        return parser.error("unexpected '" + source.substr(parser.position, 1) + "'");
+    }
+
+    if (total <= 0) {
+        program.clear();
+        return "the expression can never score above 0";
+    }
+
+    // An individual only scores 1 if some character that mutations can produce satisfies every weighted term at each
+    // position, otherwise the evolution would never end.
+    std::vector<std::bitset<256>> masks(sets.size());
+    for (std::size_t set = 0; set < sets.size(); set++) {
+        for (int c = 0; c < 256; c++) {
+            masks[set][static_cast<std::size_t>(c)] = sets[set][static_cast<std::size_t>(c)] != 0;
+        }
+    }
+
+    std::bitset<256> producible;
+    for (int c = 0; c < CHAR_MAX; c++) {
+        producible.set(static_cast<std::size_t>(c));
+    }
+
+    for (std::size_t i = 0; i < length; i++) {
+
+        std::bitset<256> satisfying = producible;
+        for (const Instruction &instruction : program) {
+            if (instruction.weight > 0 && instruction.begin <= i && i < instruction.end) {
+                satisfying &= instruction.opcode == Opcode::MATCH
+                              ? std::bitset<256>().set(static_cast<unsigned char>(target[i]))
+                              : masks[instruction.set];
+            }
+        }
+
+        if (satisfying.none()) {
+            program.clear();
+            return "the expression can never score 1, as no character satisfies every term at position "
+                   + std::to_string(i);
+        }
+
+    }
+
+    return "";
+
+}
+
+
+void FitnessExpression::evaluate(const Population &population, const std::string &target,
+                                 std::vector<double> &scores) {
+
+    scores.assign(population.size(), 0);
+
+    for (std::size_t tile = 0; tile < population.size(); tile += TILE_SIZE) {
+
+        const std::size_t end = std::min(tile + TILE_SIZE, population.size());
+
+        // Dispatch once per instruction, and run the instruction across the whole tile.
+        for (const Instruction &instruction : program) {
+
+            const auto *goal = reinterpret_cast<const unsigned char *>(target.data());
+
+            for (std::size_t n = tile; n < end; n++) {
+
+                const auto *genome = reinterpret_cast<const unsigned char *>(population[n]);
+                unsigned count = 0;
+
+                if (instruction.opcode == Opcode::MATCH) {
+                    for (std::uint32_t i = instruction.begin; i < instruction.end; i++) {
+                        count += genome[i] == goal[i];
+                    }
+                } else {
+                    const std::uint8_t *set = sets[instruction.set].data();
+                    for (std::uint32_t i = instruction.begin; i < instruction.end; i++) {
+                        count += set[genome[i]];
+                    }
+                }
+
+                scores[n] += instruction.weight * count;
+
+            }
+
+        }
+
+        for (std::size_t n = tile; n < end; n++) {
+            scores[n] /= total;
+        }
+
+    }
+
+}
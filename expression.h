@@ -0,0 +1,97 @@
+#ifndef EXPRESSION_H
+#define EXPRESSION_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "batch_fitness.h"
+
+
+/**
+ * A fitness function written in a small expression language, compiled once at startup into bytecode.
+ *
+ * An expression is a sum of weighted terms, such as "2*match@0..8 + match + [aeiou]@20..30", where each term is:
+ *  - An optional weight followed by '*', which defaults to 1.
+ *  - A predicate, which is one of:
+ *     - 'match', which holds if the character equals the target's character at the same position.
+ *     - A character class: 'alpha', 'digit', 'space', 'upper', 'lower', 'punct' or 'print'.
+ *     - A set of characters in brackets, such as '[aeiou]'.
+ *     - A single quoted character, such as "'x'".
+ *  - An optional position range, either '@i' for a single position or '@i..j' for positions [i, j), which defaults to
+ *    every position.
+ *
+ * The score of an individual is the weighted amount of positions where the predicates hold, divided by the largest
+ * possible total, so an individual which satisfies every term scores 1. Expressions that no individual can satisfy in
+ * full, such as "alpha + digit", are rejected.
+ */
+class FitnessExpression : public BatchFitness {
+
+public:
+
+    /**
+     * Compiles an expression, replacing any expression that was previously compiled.
+     *
+     * @param source The expression.
+     * @param target The target of the individuals that will be scored, which 'match' compares them to.
+     *
+     * @return An empty string if the expression compiled, otherwise a description of the error.
+     */
+    std::string compile(const std::string &source, const std::string &target);
+
+    /**
+     * @return If an expression has been compiled.
+     */
+    [[nodiscard]] bool compiled() const {
+        return !program.empty();
+    }
+
+    /**
+     * Scores a population by running each instruction across a tile of individuals before moving to the next one.
+     */
+    void evaluate(const Population &population, const std::string &target, std::vector<double> &scores) override;
+
+    /**
+     * @return True, as scoring only reads the compiled program.
+     */
+    [[nodiscard]] bool reentrant() const override {
+        return true;
+    }
+
+private:
+
+    /// The operations an instruction can perform.
+    enum class Opcode : std::uint8_t {
+
+        /// Counts the positions where the character equals the target's.
+        MATCH,
+
+        /// Counts the positions where the character is in a set.
+        SET
+
+    };
+
+    /// A single compiled term.
+    struct Instruction {
+        Opcode opcode;
+        std::uint32_t begin;
+        std::uint32_t end;
+        double weight;
+
+        /// The index of the set within {@link sets}, for {@link Opcode::SET}.
+        std::uint32_t set;
+    };
+
+    /// The compiled terms of the expression.
+    std::vector<Instruction> program;
+
+    /// The character sets used by the program, as a lookup table of 0 or 1 for every character.
+    std::vector<std::array<std::uint8_t, 256>> sets;
+
+    /// The largest possible weighted total, which scores are divided by.
+    double total = 0;
+
+};
+
+#endif
@@ -0,0 +1,58 @@
+/**
+ * The interface for fitness functions that are loaded at runtime from a shared object with '--plugin <path>'.
+ *
+ * A plugin must export {@link fitness_plugin_abi} and {@link fitness_plugin_evaluate} with C linkage. Individuals are
+ * handed over in batches rather than one at a time, so the cost of the indirect call is paid once per tile of the
+ * population and the plugin is free to vectorize across the whole batch. A score of 1 or more ends the search.
+ */
+#ifndef FITNESS_PLUGIN_H
+#define FITNESS_PLUGIN_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/// The version of this interface. A plugin built against a different version is rejected when it is loaded.
+#define FITNESS_PLUGIN_ABI_VERSION 1
+
+/// A read-only view of a batch of individuals, along with the array that the plugin writes their scores into.
+typedef struct fitness_batch {
+
+    /// The individuals to evaluate. Each one is exactly 'length' characters long and is not null-terminated.
+    const char *const *genomes;
+
+    /// How many individuals are in the batch.
+    size_t count;
+
+    /// The length of every individual, and of the target.
+    size_t length;
+
+    /// The target value for the mutations.
+    const char *target;
+
+    /// The output array with room for 'count' scores, where scores[i] is the score of genomes[i].
+    double *scores;
+
+} fitness_batch;
+
+/**
+ * Reports the version of the interface the plugin was built against.
+ *
+ * @return {@link FITNESS_PLUGIN_ABI_VERSION}.
+ */
+int fitness_plugin_abi(void);
+
+/**
+ * Evaluates every individual in a batch.
+ *
+ * @param batch The batch to evaluate.
+ */
+void fitness_plugin_evaluate(const fitness_batch *batch);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,204 @@
+#include "initializer.h"
+
+#include <climits>
+#include <fstream>
+#include <utility>
+
+#include "random.h"
+
+
+namespace {
+
+    /**
+     * Finds the first individual or position in a worker's share of a range.
+     */
+    std::size_t share_begin(const std::size_t total, const std::size_t worker, const std::size_t workers) {
+        return total * worker / workers;
+    }
+
+    /**
+     * A random permutation of [0, size), which maps any index without the rest of the permutation being stored. It is
+     * a Feistel network over the smallest even power of two that covers the range, which walks the cycle of an index
+     * until it lands back within the range.
+     */
+    class IndexPermutation {
+
+    public:
+
+        IndexPermutation(const std::size_t size, const std::uint64_t seed) : size(size) {
+
+            int bits = 2;
+            while (bits < 64 && (std::uint64_t(1) << bits) < size) {
+                bits += 2;
+            }
+            half_bits = bits / 2;
+            half_mask = (std::uint64_t(1) << half_bits) - 1;
+
+            for (std::size_t round = 0; round < ROUNDS; round++) {
+                keys[round] = splitmix64(seed + round);
+            }
+
+        }
+
+        std::size_t operator()(const std::size_t index) const {
+
+            std::uint64_t value = index;
+            do {
+                std::uint64_t left = value >> half_bits;
+                std::uint64_t right = value & half_mask;
+                for (const std::uint64_t key : keys) {
+                    const std::uint64_t mixed = left ^ (splitmix64(right ^ key) & half_mask);
+                    left = right;
+                    right = mixed;
+                }
+                value = left << half_bits | right;
+            } while (value >= size);
+
+            return static_cast<std::size_t>(value);
+
+        }
+
+    private:
+
+        static constexpr std::size_t ROUNDS = 4;
+
+        std::uint64_t size;
+        int half_bits = 1;
+        std::uint64_t half_mask = 1;
+        std::uint64_t keys[ROUNDS]{};
+
+    };
+
+}
+
+
+void CloneInitializer::initialize(Population &population, WorkerPool &pool, std::uint64_t) {
+
+    pool.run([&](const std::size_t worker) {
+        population.fill(individual, share_begin(population.size(), worker, pool.size()),
+                        share_begin(population.size(), worker + 1, pool.size()));
+    });
+
+}
+
+
+void UniformInitializer::initialize(Population &population, WorkerPool &pool, const std::uint64_t seed) {
+
+    pool.run([&](const std::size_t worker) {
+
+        const std::size_t end = share_begin(population.size(), worker + 1, pool.size());
+
+        for (std::size_t i = share_begin(population.size(), worker, pool.size()); i < end; i++) {
+
+            Random random(stream_seed(seed, StreamPurpose::INITIALIZATION, i));
+            char *individual = population[i];
+            for (std::size_t j = 0; j < population.length(); j++) {
+                individual[j] = static_cast<char>(random.below(CHAR_MAX));
+            }
+
+        }
+
+    });
+
+}
+
+
+void StratifiedInitializer::initialize(Population &population, WorkerPool &pool, const std::uint64_t seed) {
+
+    const std::size_t size = population.size();
+
+    // Every position deals its strata in its own order, which any worker can look up for any individual.
+    std::vector<IndexPermutation> orders;
+    orders.reserve(population.length());
+    for (std::size_t j = 0; j < population.length(); j++) {
+        orders.emplace_back(size, stream_seed(seed, StreamPurpose::STRATA, j));
+    }
+
+    // Each worker writes whole individuals, so that no two workers write to the same cache line or page.
+    pool.run([&](const std::size_t worker) {
+
+        const std::size_t end = share_begin(size, worker + 1, pool.size());
+
+        for (std::size_t i = share_begin(size, worker, pool.size()); i < end; i++) {
+
+            // Draw a character from within the individual's stratum at every position.
+            Random random(stream_seed(seed, StreamPurpose::INITIALIZATION, i));
+            char *individual = population[i];
+            for (std::size_t j = 0; j < population.length(); j++) {
+                const double stratum = static_cast<double>(orders[j](i));
+                individual[j] = static_cast<char>((stratum + random.chance()) / static_cast<double>(size) * CHAR_MAX);
+            }
+
+        }
+
+    });
+
+}
+
+
+std::string HintInitializer::load(const std::string &path) {
+
+    std::ifstream file(path);
+    if (!file) {
+        return "could not open " + path;
+    }
+
+    hints.clear();
+    for (std::string line; std::getline(file, line);) {
+        if (!line.empty()) {
+            hints.push_back(line);
+        }
+    }
+
+    return hints.empty() ? path + " has no hints" : "";
+
+}
+
+
+void HintInitializer::initialize(Population &population, WorkerPool &pool, const std::uint64_t seed) {
+
+    pool.run([&](const std::size_t worker) {
+
+        const std::size_t end = share_begin(population.size(), worker + 1, pool.size());
+
+        for (std::size_t i = share_begin(population.size(), worker, pool.size()); i < end; i++) {
+
+            Random random(stream_seed(seed, StreamPurpose::INITIALIZATION, i));
+            const std::string &hint = hints[i % hints.size()];
+            char *individual = population[i];
+
+            for (std::size_t j = 0; j < population.length(); j++) {
+                individual[j] = j < hint.length() && hint[j] != WILDCARD
+                                ? hint[j]
+                                : static_cast<char>(random.below(CHAR_MAX));
+            }
+
+        }
+
+    });
+
+}
+
+
+std::string make_initializer(const std::string &name, const std::string_view individual,
+                             const std::string &hints_path, std::unique_ptr<Initializer> &initializer) {
+
+    if (name == "clone") {
+        initializer = std::make_unique<CloneInitializer>(std::string(individual));
+    } else if (name == "uniform") {
+        initializer = std::make_unique<UniformInitializer>();
+    } else if (name == "stratified") {
+        initializer = std::make_unique<StratifiedInitializer>();
+    } else if (name == "hints") {
+        auto hints = std::make_unique<HintInitializer>();
+        if (std::string message = hints->load(hints_path); !message.empty()) {
+            return message;
+        }
+        initializer = std::move(hints);
+    } else {
+        return "unknown initializer " + name;
+    }
+
+    return "";
+
+}
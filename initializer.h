@@ -0,0 +1,132 @@
+#ifndef INITIALIZER_H
+#define INITIALIZER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "population.h"
+#include "threads.h"
+
+
+/**
+ * Fills a population with its first individuals. Initializers write straight into the population's buffer, with every
+ * worker of a pool writing its own share of whole individuals, and draw from a random stream per individual or per
+ * position rather than per worker, so the population is the same whichever amount of workers generate it.
+ *
+ * Every character is drawn from [0, CHAR_MAX), like the mutations.
+ */
+class Initializer {
+
+public:
+
+    virtual ~Initializer() = default;
+
+    /**
+     * Fills every individual of a population.
+     *
+     * @param population The population to fill.
+     * @param pool The workers which fill the population, each filling its own part of it.
+     * @param seed The seed of the random streams.
+     */
+    virtual void initialize(Population &population, WorkerPool &pool, std::uint64_t seed) = 0;
+
+};
+
+
+/**
+ * Copies the same individual into every individual.
+ */
+class CloneInitializer : public Initializer {
+
+public:
+
+    /**
+     * @param individual The individual to copy.
+     */
+    explicit CloneInitializer(std::string individual) : individual(std::move(individual)) {}
+
+    void initialize(Population &population, WorkerPool &pool, std::uint64_t seed) override;
+
+private:
+
+    std::string individual;
+
+};
+
+
+/**
+ * Draws every character of every individual independently and uniformly.
+ */
+class UniformInitializer : public Initializer {
+
+public:
+
+    void initialize(Population &population, WorkerPool &pool, std::uint64_t seed) override;
+
+};
+
+
+/**
+ * Stratifies the characters at every position across the population, like a Latin hypercube. The range of characters
+ * is split into as many strata as there are individuals, and each position deals one character from every stratum to
+ * the individuals in a random order. Every position then covers the whole range evenly, where uniform draws leave gaps
+ * and repeats. Populations larger than the range of characters deal some characters more than once. The order of each
+ * position is a permutation that can be looked up for any individual, so that workers can split the individuals
+ * between them rather than the positions.
+ */
+class StratifiedInitializer : public Initializer {
+
+public:
+
+    void initialize(Population &population, WorkerPool &pool, std::uint64_t seed) override;
+
+};
+
+
+/**
+ * Starts from hints, such as the results of earlier runs or known parts of the target. The hints are dealt to the
+ * individuals in turn, and any character that a hint does not give is drawn uniformly, including every '?' and every
+ * position past the end of the hint.
+ */
+class HintInitializer : public Initializer {
+
+public:
+
+    /// The character that leaves a position of a hint to be drawn at random.
+    static constexpr char WILDCARD = '?';
+
+    /**
+     * Loads the hints from a file, one per line.
+     *
+     * @param path The path of the file.
+     *
+     * @return An empty string if at least one hint was loaded, otherwise a description of the error.
+     */
+    std::string load(const std::string &path);
+
+    void initialize(Population &population, WorkerPool &pool, std::uint64_t seed) override;
+
+private:
+
+    std::vector<std::string> hints;
+
+};
+
+
+/**
+ * Creates an initializer by name.
+ *
+ * @param name The name of the initializer, which is one of "clone", "uniform", "stratified" or "hints".
+ * @param individual The individual that the "clone" initializer copies.
+ * @param hints_path The file that the "hints" initializer loads its hints from.
+ * @param initializer The initializer, which is only written to if it was created.
+ *
+ * @return An empty string if the initializer was created, otherwise a description of the error.
+ */
+std::string make_initializer(const std::string &name, std::string_view individual, const std::string &hints_path,
+                             std::unique_ptr<Initializer> &initializer);
+
+#endif
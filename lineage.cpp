@@ -0,0 +1,125 @@
+#include "lineage.h"
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/stat.h>
+
+
+namespace {
+
+    /**
+     * Appends a column's buffered values to its file, and empties the buffer.
+     */
+    template<typename T>
+    void append(std::ofstream &file, std::vector<T> &values) {
+
+        file.write(reinterpret_cast<const char *>(values.data()),
+                   static_cast<std::streamsize>(values.size() * sizeof(T)));
+        values.clear();
+
+    }
+
+}
+
+
+std::string LineageLog::open(const std::string &path) {
+
+    if (mkdir(path.c_str(), 0755) != 0 && errno != EEXIST) {
+        return "could not create " + path + ": " + std::strerror(errno);
+    }
+
+    // Replace the log of any earlier run, as operators.csv will be, so that the columns only ever hold one run.
+    directory = path;
+    generation_column.open(path + "/generation.u32", std::ios::binary | std::ios::trunc);
+    index_column.open(path + "/index.u32", std::ios::binary | std::ios::trunc);
+    parent_column.open(path + "/parent.u32", std::ios::binary | std::ios::trunc);
+    mutations_column.open(path + "/mutations.u16", std::ios::binary | std::ios::trunc);
+    delta_column.open(path + "/delta.i32", std::ios::binary | std::ios::trunc);
+
+    if (!generation_column || !index_column || !parent_column || !mutations_column || !delta_column) {
+        return "could not open the columns in " + path;
+    }
+
+    return "";
+
+}
+
+
+void LineageLog::record(const int generation, const long parent, const std::size_t elite,
+                        const std::vector<std::uint16_t> &mutations, const std::vector<std::int32_t> &deltas) {
+
+    // Count every offspring by its mutations, which is all that is kept of the lineages that are now extinct.
+    for (std::size_t i = 0; i < mutations.size(); i++) {
+
+        if (mutations[i] >= histogram.size()) {
+            histogram.resize(mutations[i] + 1);
+        }
+
+        Outcomes &outcomes = histogram[mutations[i]];
+        outcomes.offspring++;
+        outcomes.improved += deltas[i] < 0;
+        outcomes.neutral += deltas[i] == 0;
+        outcomes.worsened += deltas[i] > 0;
+        improved += deltas[i] < 0;
+
+    }
+    histogram[mutations[elite]].selected++;
+    recorded += mutations.size();
+
+    // Only the elite carries on, so its record is the only one that is logged.
+    generations.push_back(static_cast<std::uint32_t>(generation));
+    indices.push_back(static_cast<std::uint32_t>(elite));
+    parents.push_back(static_cast<std::uint32_t>(parent < 0 ? elite : static_cast<std::size_t>(parent)));
+    elite_mutations.push_back(mutations[elite]);
+    elite_deltas.push_back(deltas[elite]);
+    logged++;
+
+    if (generations.size() >= FLUSH_RECORDS) {
+        flush();
+    }
+
+}
+
+
+void LineageLog::flush() {
+
+    append(generation_column, generations);
+    append(index_column, indices);
+    append(parent_column, parents);
+    append(mutations_column, elite_mutations);
+    append(delta_column, elite_deltas);
+
+}
+
+
+std::string LineageLog::close() {
+
+    flush();
+    generation_column.close();
+    index_column.close();
+    parent_column.close();
+    mutations_column.close();
+    delta_column.close();
+
+    if (!generation_column || !index_column || !parent_column || !mutations_column || !delta_column) {
+        return "could not write the columns in " + directory;
+    }
+
+    std::ofstream file(directory + "/operators.csv", std::ios::trunc);
+    file << "mutations,offspring,improved,neutral,worsened,selected\n";
+    for (std::size_t count = 0; count < histogram.size(); count++) {
+        const Outcomes &outcomes = histogram[count];
+        if (outcomes.offspring > 0) {
+            file << count << ',' << outcomes.offspring << ',' << outcomes.improved << ',' << outcomes.neutral << ','
+                 << outcomes.worsened << ',' << outcomes.selected << '\n';
+        }
+    }
+
+    if (!file) {
+        return "could not write " + directory + "/operators.csv";
+    }
+
+    return "";
+
+}
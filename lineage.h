@@ -0,0 +1,131 @@
+#ifndef LINEAGE_H
+#define LINEAGE_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+/**
+ * Records the genealogy of a lockstep evolution, so that which mutations lead to improvements can be analyzed after
+ * the run without a snapshot of every individual.
+ *
+ * Every offspring is tracked by its parent and by how many characters it mutated, which the engine keeps in compact
+ * columns alongside the population. Once a generation is selected, only the elite has descendants, so the lineages of
+ * every other offspring are extinct. Those are pruned straight away and only counted in a histogram by mutation count,
+ * while the surviving lineage is appended to the log. Memory therefore stays bounded by the population, however long
+ * the run is.
+ *
+ * The log is a directory of columns, each a file of integers in the byte order of the machine that the run appends to,
+ * with one entry per generation:
+ *
+ * - generation.u32: the generation.
+ * - index.u32: the index of the elite within the population.
+ * - parent.u32: the index of its parent within the previous generation.
+ * - mutations.u16: how many characters it mutated.
+ * - delta.i32: how much its mutations changed its error, where negative is an improvement.
+ *
+ * When the log is closed, operators.csv is written with how many offspring made each amount of mutations, how many of
+ * them improved, kept or worsened their error, and how many were selected.
+ */
+class LineageLog {
+
+public:
+
+    /// How many records are buffered before they are appended to the columns.
+    static constexpr std::size_t FLUSH_RECORDS = 4096;
+
+    LineageLog() = default;
+    LineageLog(const LineageLog &) = delete;
+    LineageLog &operator=(const LineageLog &) = delete;
+
+    /**
+     * Creates the directory if needed, and opens its columns, replacing any log that an earlier run left in it.
+     *
+     * @param path The directory.
+     *
+     * @return An empty string on success, otherwise a description of the error.
+     */
+    std::string open(const std::string &path);
+
+    /**
+     * Records a generation once it has been selected, before the population is refilled.
+     *
+     * @param generation The generation, starting at 1.
+     * @param parent The index of the parent of every offspring, or -1 in the first generation, where every offspring
+     * descends from the individual at its own index.
+     * @param elite The index of the selected individual.
+     * @param mutations How many characters each offspring mutated.
+     * @param deltas How much each offspring's mutations changed its error.
+     */
+    void record(int generation, long parent, std::size_t elite, const std::vector<std::uint16_t> &mutations,
+                const std::vector<std::int32_t> &deltas);
+
+    /**
+     * Appends the buffered records, and writes the histogram of operators.
+     *
+     * @return An empty string on success, otherwise a description of the error.
+     */
+    std::string close();
+
+    /**
+     * @return How many records of the surviving lineage were logged.
+     */
+    [[nodiscard]] std::uint64_t survivors() const {
+        return logged;
+    }
+
+    /**
+     * @return How many offspring were recorded, including those whose lineages were pruned.
+     */
+    [[nodiscard]] std::uint64_t offspring() const {
+        return recorded;
+    }
+
+    /**
+     * @return How many offspring had a lower error than their parent.
+     */
+    [[nodiscard]] std::uint64_t improvements() const {
+        return improved;
+    }
+
+private:
+
+    /// The outcomes of every offspring that made a certain amount of mutations.
+    struct Outcomes {
+        std::uint64_t offspring = 0;
+        std::uint64_t improved = 0;
+        std::uint64_t neutral = 0;
+        std::uint64_t worsened = 0;
+        std::uint64_t selected = 0;
+    };
+
+    /// Appends the buffered records to the columns.
+    void flush();
+
+    std::string directory;
+
+    std::ofstream generation_column;
+    std::ofstream index_column;
+    std::ofstream parent_column;
+    std::ofstream mutations_column;
+    std::ofstream delta_column;
+
+    /// The records of the surviving lineage that have not been appended yet.
+    std::vector<std::uint32_t> generations;
+    std::vector<std::uint32_t> indices;
+    std::vector<std::uint32_t> parents;
+    std::vector<std::uint16_t> elite_mutations;
+    std::vector<std::int32_t> elite_deltas;
+
+    /// The outcomes by mutation count, which grows to the most mutations any offspring made.
+    std::vector<Outcomes> histogram;
+
+    std::uint64_t logged = 0;
+    std::uint64_t recorded = 0;
+    std::uint64_t improved = 0;
+
+};
+
+#endif
@@ -4,186 +4,801 @@
 #include <vector>
 #include <algorithm>
 #include <chrono>
-
-
-/// How many individuals a population should be comprised of.
+#include <climits>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <memory>
+
+#include "admission.h"
+#include "batch.h"
+#include "cache.h"
+#include "calibration.h"
+#include "chunked.h"
+#include "control.h"
+#include "dashboard.h"
+#include "engine.h"
+#include "expression.h"
+#include "initializer.h"
+#include "lineage.h"
+#include "memory.h"
+#include "novelty.h"
+#include "observer.h"
+#include "plugin.h"
+#include "population.h"
+#include "probes.h"
+#include "steady_state.h"
+#include "surrogate.h"
+#include "threads.h"
+#include "trace.h"
+
+
+/// How many individuals a population should be comprised of, unless the '--population' argument is given.
 static constexpr int POPULATION_SIZE = 100;
 
-/// The target value for the mutations.
+/// The target value for the mutations, unless the '--target' argument is given.
 static const std::string TARGET = "Computer Science 1944 Cool Topics Project";
 
-/// The chance for each value to mutate.
+/// The chance for each value to mutate, unless the '--mutation-chance' argument is given.
 static constexpr double MUTATION_CHANCE = 0.01;
 
-/// Lambda for generating a pseudo-random character.
-static constexpr auto random_char = []() -> char {
-    return rand() % CHAR_MAX;
-};
+/// How many events each thread can record when tracing, beyond which events are dropped.
+static constexpr std::size_t TRACE_CAPACITY = 1 << 20;
 
 
 /**
- * Evaluates a string's fitness score.
+ * The entry-point for the program. Utilizes a genetic algorithm to mutate a random string into the target string.
  *
- * @param individual The string to compare to the target.
+ * @param argc The amount of arguments passed.
+ * @param argv The arguments passed.
  *
- * @return The fitness score of the string.
+ * @return The exit code.
  */
-double fitness(const std::string &individual) {
+int main(const int argc, const char *argv[]) {
+
+    // The settings of the evolution, which the arguments below can change.
+    EvolutionSettings settings{TARGET, MUTATION_CHANCE};
+
+    // The seed of every random number generator, which is the current time unless the '--seed' argument is given.
+    auto seed = static_cast<std::uint64_t>(time(nullptr));
+
+    // The directory to cache results in, if any, and the file of targets to solve as a batch, if any.
+    std::string cache_path;
+    std::string batch_path;
+
+    // The most memory that the populations of the run, or of the batch's concurrent jobs, may need at once, if bounded.
+    std::size_t memory_budget = 0;
+
+    // Should the program prompt for user input before terminating the program? This is useful is an external console
+    // is used, as the console will close after the program terminates.
+    bool pause = false;
+
+    // The path of a fitness plugin to use in place of the built-in fitness function, if any.
+    std::string plugin_path;
+
+    // An expression to use in place of the built-in fitness function, if any.
+    std::string expression_source;
+
+    // The fraction of the population to truly evaluate after screening it with a surrogate model, or 0 to disable.
+    double surrogate_fraction = 0;
+
+    // How much of each score comes from novelty rather than fitness, or 0 to disable novelty search.
+    double novelty_weight = 0;
+
+    // How many individuals the population is comprised of.
+    std::size_t population_size = POPULATION_SIZE;
+
+    // How the first individuals are generated, and the file of hints to start from if they come from hints.
+    std::string initializer_name = "clone";
+    std::string hints_path;
+
+    // The path of a file to keep the population in, so that it can be larger than memory, if any.
+    std::string population_path;
+
+    // How many threads run the generation loop, or 0 for one per CPU.
+    std::size_t thread_count = 1;
+
+    // Should each thread be pinned to its own CPU, and should SMT siblings be skipped when choosing them?
+    bool pin = false;
+    bool physical_cores = false;
+
+    // Should workers breed and replace individuals one at a time without waiting for each other, instead of in
+    // generations?
+    bool async = false;
+
+    // Should genomes be stored as shared, copy-on-write chunks instead of a copy of every character?
+    bool chunked = false;
+
+    // Should the execution plan be chosen by measuring the candidates at startup, and where should it be cached?
+    bool calibrate_plan = false;
+    std::string calibration_path;
+
+    // The path of a file to watch for changes to the settings while the program runs, if any.
+    std::string control_path;
+
+    // The directory to log the genealogy of the run to, if any.
+    std::string lineage_path;
+
+    // The path to write a timeline of every generation to, if any.
+    std::string trace_path;
+
+    // Should the individual with the peak fitness score be left out of the output each generation?
+    bool quiet = false;
+
+    // Should a dashboard be drawn in the terminal instead of printing a line per generation?
+    bool dashboard_enabled = false;
+
+    // Should a report of the memory used by the population and the allocations made be printed at exit?
+    bool memory_report = false;
+
+    // Stores the arguments as a vector of strings.
+    const std::vector<std::string> args(argv, argv + argc);
+
+    // Loop over each argument, except for argv[0], because the program path is in argv[0].
+    for (std::size_t i = 1; i < args.size(); i++) {
+        if (args[i] == "--pause") {
+            pause = true;
+        } else if (args[i] == "--target" && i + 1 < args.size()) {
+            settings.target = args[++i];
+        } else if (args[i] == "--seed" && i + 1 < args.size()) {
+            seed = std::stoull(args[++i]);
+        } else if (args[i] == "--cache" && i + 1 < args.size()) {
+            cache_path = args[++i];
+        } else if (args[i] == "--batch" && i + 1 < args.size()) {
+            batch_path = args[++i];
+        } else if (args[i] == "--memory-budget" && i + 1 < args.size()) {
+            if (!parse_bytes(args[++i], memory_budget) || memory_budget == 0) {
+                std::cerr << "Failed to parse memory budget: " << args[i] << " is not an amount such as 512M"
+                          << std::endl;
+                return 1;
+            }
+        } else if (args[i] == "--graded") {
+            settings.fitness_mode = FitnessMode::GRADED;
+        } else if (args[i] == "--plugin" && i + 1 < args.size()) {
+            plugin_path = args[++i];
+        } else if (args[i] == "--expression" && i + 1 < args.size()) {
+            expression_source = args[++i];
+        } else if (args[i] == "--surrogate" && i + 1 < args.size()) {
+            surrogate_fraction = std::stod(args[++i]);
+        } else if (args[i] == "--novelty" && i + 1 < args.size()) {
+            novelty_weight = std::stod(args[++i]);
+        } else if (args[i] == "--population" && i + 1 < args.size()) {
+            population_size = std::stoull(args[++i]);
+        } else if (args[i] == "--mutation-chance" && i + 1 < args.size()) {
+            settings.mutation_chance = std::stod(args[++i]);
+        } else if (args[i] == "--init" && i + 1 < args.size()) {
+            initializer_name = args[++i];
+        } else if (args[i] == "--hints" && i + 1 < args.size()) {
+            initializer_name = "hints";
+            hints_path = args[++i];
+        } else if (args[i] == "--population-file" && i + 1 < args.size()) {
+            population_path = args[++i];
+        } else if (args[i] == "--threads" && i + 1 < args.size()) {
+            thread_count = std::stoull(args[++i]);
+        } else if (args[i] == "--pin") {
+            pin = true;
+        } else if (args[i] == "--physical-cores") {
+            physical_cores = true;
+        } else if (args[i] == "--calibrate") {
+            calibrate_plan = true;
+        } else if (args[i] == "--calibration-file" && i + 1 < args.size()) {
+            calibrate_plan = true;
+            calibration_path = args[++i];
+        } else if (args[i] == "--async") {
+            async = true;
+        } else if (args[i] == "--chunked") {
+            chunked = true;
+        } else if (args[i] == "--sparse") {
+            settings.sparse = true;
+        } else if (args[i] == "--control" && i + 1 < args.size()) {
+            control_path = args[++i];
+        } else if (args[i] == "--lineage" && i + 1 < args.size()) {
+            lineage_path = args[++i];
+        } else if (args[i] == "--trace" && i + 1 < args.size()) {
+            trace_path = args[++i];
+        } else if (args[i] == "--quiet") {
+            quiet = true;
+        } else if (args[i] == "--dashboard") {
+            dashboard_enabled = true;
+        } else if (args[i] == "--memory-report") {
+            memory_report = true;
+        }
+    }
+
+    // Every character of a target must be one that mutations can produce, otherwise the search would never end.
+    const auto reachable = [](const std::string &target) {
+        return !target.empty() && std::all_of(target.begin(), target.end(), [](const char c) {
+            return static_cast<unsigned char>(c) < CHAR_MAX;
+        });
+    };
+    if (!reachable(settings.target)) {
+        std::cerr << "The target must not be empty, and may only contain characters below " << CHAR_MAX << std::endl;
+        return 1;
+    }
 
-    int matches = 0;
+    // A population needs at least one individual to choose the elite from.
+    if (population_size < 1) {
+        std::cerr << "The population must have at least 1 individual" << std::endl;
+        return 1;
+    }
+
+    // More threads than a few per CPU would only add overhead, and the same limit applies to the control file.
+    if (const std::size_t limit = thread_limit(detect_topology()); thread_count > limit) {
+        std::cerr << "The thread count must be at most " << limit << ", " << THREADS_PER_CPU << " per available CPU"
+                  << std::endl;
+        return 1;
+    }
 
-    // Check how many values match.
-    for (int i = 0; i < individual.length(); i++) {
-        if (individual.at(i) == TARGET.at(i)) {
-            matches++;
+    // The same range that the control file accepts.
+    if (!(settings.mutation_chance >= 0 && settings.mutation_chance <= 1)) {
+        std::cerr << "The mutation chance must be within [0, 1]" << std::endl;
+        return 1;
+    }
+
+    // Every job of a batch is evolved on its own thread with the built-in fitness function, from flat genomes in memory
+    // that start as copies of one individual, so settings that would change any of that cannot be applied to it.
+    if (!batch_path.empty() && (!plugin_path.empty() || !expression_source.empty() || surrogate_fraction != 0
+                                || novelty_weight != 0 || initializer_name != "clone" || async || chunked
+                                || !population_path.empty() || calibrate_plan)) {
+        std::cerr << "--batch cannot be used with --plugin, --expression, --surrogate, --novelty, --init, --hints, "
+                     "--async, --chunked, --population-file or --calibrate" << std::endl;
+        return 1;
+    }
+
+    // A single run that would not fit the memory budget is degraded to chunked genomes, if it can be evolved with them
+    // and they fit, since chunks are only copied when they mutate.
+    if (memory_budget > 0 && batch_path.empty() && !chunked
+        && estimate_footprint(population_size, settings.target.length(), settings.mutation_chance, false)
+           > memory_budget) {
+        if (!plugin_path.empty() || !expression_source.empty() || novelty_weight > 0 || async || !control_path.empty()
+            || !lineage_path.empty() || !population_path.empty() || thread_count != 1 || calibrate_plan
+            || initializer_name != "clone"
+            || estimate_footprint(population_size, settings.target.length(), settings.mutation_chance, true)
+               > memory_budget) {
+            std::cerr << "Failed to admit run: its population would not fit the memory budget of " << memory_budget
+                      << " bytes" << std::endl;
+            return 1;
         }
+        std::cout << "Degraded to chunked genomes to fit the memory budget of " << memory_budget << " bytes"
+                  << std::endl;
+        chunked = true;
     }
 
-    return static_cast<double>(matches) / static_cast<double>(individual.length());
+    // Every setting that changes the outcome of an evolution, which results are cached under along with the target and
+    // the seed. Only the settings that a batch job uses are written here, and those of a single run follow the batch.
+    std::ostringstream parameters;
+    parameters.precision(17);
+    parameters << "population=" << population_size << " mutation=" << settings.mutation_chance
+               << " graded=" << (settings.fitness_mode == FitnessMode::GRADED) << " sparse=" << settings.sparse;
+
+    ResultCache cache;
+    if (!cache_path.empty()) {
+        if (const std::string message = cache.open(cache_path); !message.empty()) {
+            std::cerr << "Failed to open cache: " << message << std::endl;
+            return 1;
+        }
+    }
 
-}
+    // Solve every target of a batch with the built-in fitness function, several at once, and stop.
+    if (!batch_path.empty()) {
 
+        std::ifstream file(batch_path);
+        std::vector<std::string> targets;
+        for (std::string line; std::getline(file, line);) {
+            if (!line.empty()) {
+                targets.push_back(line);
+            }
+        }
 
-/**
- * Attempts to mutate characters within a string, and the chance to mutate is defined in {@link MUTATION_CHANCE}.
- *
- * @param individual The individual to mutate.
- *
- * @return The amount of mutations that occurred.
- */
-int mutate(std::string &individual) {
+        if (!file.eof() || !std::all_of(targets.begin(), targets.end(), reachable)) {
+            std::cerr << "Failed to read batch: " << batch_path << " could not be read, or has a target with a "
+                      << "character that is not below " << CHAR_MAX << std::endl;
+            return 1;
+        }
 
-    int mutations = 0;
+        AdmissionController admission(memory_budget);
+        const std::size_t jobs = thread_count == 0 ? place_threads(detect_topology(), 0, false).size() : thread_count;
+        const auto batch_start = std::chrono::steady_clock::now();
+        const std::vector<BatchResult> results = run_batch(targets, settings, population_size, seed,
+                                                           parameters.str(), jobs, cache,
+                                                           memory_budget > 0 ? &admission : nullptr);
+        const auto batch_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - batch_start);
+
+        for (const BatchResult &result : results) {
+            if (result.rejected) {
+                std::cout << result.target << "  |  rejected, would not fit the memory budget\n";
+                continue;
+            }
+            const char *source = result.source == ResultSource::CACHED
+                                 ? "cached"
+                                 : result.source == ResultSource::COALESCED ? "coalesced" : "solved";
+            std::cout << result.result.best << "  |  " << result.result.generations << " generations (" << source
+                      << (result.degraded ? ", chunked" : "") << ")\n";
+        }
+        if (memory_budget > 0) {
+            std::cout << "Memory Budget: " << admission.peak() << " of " << memory_budget << " bytes reserved at peak, "
+                      << admission.queued() << " jobs queued" << std::endl;
+        }
+        std::cout << "Time Elapsed: " << batch_time.count() << "ms" << std::endl;
 
-    // Loop through each character in the string.
-    for (char & c : individual) {
+        return 0;
 
-        // Generate a double within [0, 1].
-        // const double random = (double) rand() / (double) RAND_MAX;
+    }
 
-        // Check to see if the value should mutate.
-        if (MUTATION_CHANCE >= static_cast<double>(rand()) / static_cast<double>(RAND_MAX)) {
+    parameters << " chunked=" << chunked << " plugin=" << plugin_path << " expression=" << expression_source
+               << " surrogate=" << surrogate_fraction << " novelty=" << novelty_weight
+               << " init=" << initializer_name << " hints=" << hints_path << " async=" << async
+               << " threads=" << thread_count << " calibrate=" << calibrate_plan;
+
+    // Load the fitness plugin or expression before anything else, so that a mistake is reported straight away. When
+    // either is given, it scores the population in place of the built-in fitness function.
+    FitnessPlugin plugin;
+    FitnessExpression expression;
+    BatchFitness *batch_fitness = nullptr;
+
+    if (!plugin_path.empty()) {
+        if (const std::string message = plugin.load(plugin_path); !message.empty()) {
+            std::cerr << "Failed to load plugin: " << message << std::endl;
+            return 1;
+        }
+        batch_fitness = &plugin;
+    } else if (!expression_source.empty()) {
+        if (const std::string message = expression.compile(expression_source, settings.target);
+            !message.empty()) {
+            std::cerr << "Failed to compile expression: " << message << std::endl;
+            return 1;
+        }
+        batch_fitness = &expression;
+    }
 
-            // Select a random character to mutate into.
-            const char mutation = random_char();
+    // The plugin or expression itself, which calibration measures, since measuring through a surrogate or novelty
+    // search would train the one or fill the archive of the other before the run starts.
+    BatchFitness *const objective = batch_fitness;
 
-            // Mutate the value.
-            c = mutation;
+    // Screen the population with a surrogate before it reaches the plugin or expression.
+    std::unique_ptr<SurrogateScreen> surrogate;
+    if (surrogate_fraction > 0) {
 
-            mutations++;
+        if (batch_fitness == nullptr || surrogate_fraction > 1) {
+            std::cerr << "--surrogate requires --plugin or --expression, and a fraction within (0, 1]" << std::endl;
+            return 1;
+        }
 
+        // The surrogate ranks whole generations, which the asynchronous mode does not have.
+        if (async) {
+            std::cerr << "--surrogate cannot be used with --async" << std::endl;
+            return 1;
         }
 
+        surrogate = std::make_unique<SurrogateScreen>(*batch_fitness, surrogate_fraction, settings.target.length(),
+                                                      seed);
+        batch_fitness = surrogate.get();
+
     }
 
-    return mutations;
+    // Novelty is measured across whole generations, against an archive that the surrogate cannot model.
+    if (novelty_weight < 0 || novelty_weight > 1 || (novelty_weight > 0 && (surrogate || async))) {
+        std::cerr << "--novelty requires a weight within (0, 1], and cannot be used with --surrogate or --async"
+                  << std::endl;
+        return 1;
+    }
 
-}
+    // Chunked genomes are evolved on the calling thread with the built-in fitness function, never live in a flat
+    // buffer, and start out sharing every chunk.
+    if (chunked && (batch_fitness != nullptr || novelty_weight > 0 || async || !population_path.empty()
+                    || thread_count != 1 || calibrate_plan || initializer_name != "clone")) {
+        std::cerr << "--chunked cannot be used with --plugin, --expression, --novelty, --async, --population-file, "
+                     "--threads, --calibrate or --init" << std::endl;
+        return 1;
+    }
 
+    // Only lockstep generations have boundaries to apply changes at, and a run that is changed while it is live is not
+    // the run its cache key describes.
+    ControlChannel control;
+    if (!control_path.empty()) {
+        if (async || chunked || !cache_path.empty()) {
+            std::cerr << "--control cannot be used with --async, --chunked or --cache" << std::endl;
+            return 1;
+        }
+        if (const std::string message = control.open(control_path); !message.empty()) {
+            std::cerr << "Failed to watch control file: " << message << std::endl;
+            return 1;
+        }
+    }
 
-/**
- * Finds the highest scoring individual in a population.
- *
- * @param population The population of individuals to search through.
- *
- * @return The index of the highest scoring individual in the population.
- */
-int highest_scoring(const std::vector<std::string> &population) {
+    // Genealogy is only defined for lockstep generations, and a run whose result is cached would log nothing. The
+    // changes it logs are in the built-in error, which only drives selection when nothing else scores the population.
+    LineageLog lineage;
+    if (!lineage_path.empty()) {
+        if (async || chunked || !cache_path.empty() || batch_fitness != nullptr || novelty_weight > 0) {
+            std::cerr << "--lineage cannot be used with --async, --chunked, --cache, --plugin, --expression or "
+                         "--novelty" << std::endl;
+            return 1;
+        }
+        if (const std::string message = lineage.open(lineage_path); !message.empty()) {
+            std::cerr << "Failed to open lineage log: " << message << std::endl;
+            return 1;
+        }
+    }
+
+    // Start tracing before any worker threads exist, so that all of them are named.
+    if (!trace_path.empty()) {
+        trace_name_thread("main");
+        trace_enable(TRACE_CAPACITY);
+    }
 
-    double highest = fitness(population[0]);
-    int index = 0;
+    // Reuse the result of an identical run from the cache. The key is locked until this run stores its result, so that
+    // identical runs started at the same time wait for this one instead of repeating it.
+    const std::string job_key = cache_key(settings.target, parameters.str(), seed);
+    std::unique_ptr<ResultCache::Lock> cache_lock;
+    if (!cache_path.empty()) {
 
-    // Index 0 is excluded as it is used as the default.
-    for (int i = 1; i < POPULATION_SIZE; i++) {
+        cache_lock = std::make_unique<ResultCache::Lock>(cache, job_key);
 
-        // Check if the fitness score of the current individual is the highest.
-        if (const double fitness_score = fitness(population[i]); fitness_score > highest) {
-            highest = fitness_score;
-            index = i;
+        if (CachedResult cached; cache.lookup(job_key, cached)) {
+            std::cout << cached.best << "  |  " << cached.score << std::endl;
+            std::cout << "Completed in " << cached.generations << " generations (cached in " << cache_path << ")."
+                      << std::endl;
+            return 0;
         }
 
     }
 
-    return index;
+    // Blend novelty into whichever fitness function is in use.
+    std::unique_ptr<NoveltySearch> novelty;
+    if (novelty_weight > 0) {
+        novelty = std::make_unique<NoveltySearch>(batch_fitness, novelty_weight, settings.target.length(),
+                                                  settings.fitness_mode, seed);
+        batch_fitness = novelty.get();
+    }
 
-}
+    // The starting value for individuals, drawn from the seed as a batch job's is.
+    std::string current = starting_individual(settings.target.length(), seed);
 
+    // The initializer which generates the first individuals, loaded now so that a missing file is reported before the
+    // population is created.
+    std::unique_ptr<Initializer> initializer;
+    if (const std::string message = make_initializer(initializer_name, current, hints_path, initializer);
+        !message.empty()) {
+        std::cerr << "Failed to create initializer: " << message << std::endl;
+        return 1;
+    }
 
-/**
- * The entry-point for the program. Utilizes a genetic algorithm to mutate a random string into the target string.
- *
- * @param argc The amount of arguments passed.
- * @param argv The arguments passed.
- *
- * @return The exit code.
- */
-int main(const int argc, const char *argv[]) {
+    // Initializes a population, either in memory or in a file. Chunked genomes are kept apart from it, so it is left
+    // empty.
+    Population population;
+    if (population_path.empty()) {
+        population.resize(chunked ? 0 : population_size, settings.target.length());
+    } else if (const std::string message = population.map(population_path, population_size, settings.target.length());
+               !message.empty()) {
+        std::cerr << "Failed to map population: " << message << std::endl;
+        return 1;
+    }
+    population.fill(current);
+
+    // Choose where the worker threads run. The CPUs are only used when pinning, or to size the pool when asked for one
+    // thread per CPU or per physical core.
+    const Topology topology = detect_topology();
+    const std::vector<int> available_cpus = place_threads(topology, 0, physical_cores);
+
+    ExecutionPlan plan{thread_count == 0 ? available_cpus.size() : thread_count, settings.sparse};
+    std::string plan_source = "arguments";
+
+    // Calibrate by running a few generations of every candidate on the real population, then restoring it. Thread
+    // counts are doubled up to the amount of available CPUs, and each is tried with both mutation kernels.
+    const std::string fitness_description = (settings.fitness_mode == FitnessMode::GRADED ? "graded" : "exact")
+                                            + (" plugin=" + plugin_path) + " expression=" + expression_source;
+    const std::string key = calibration_key(population_size, settings.target.length(), available_cpus.size(),
+                                            settings.mutation_chance, fitness_description);
+    if (calibrate_plan && !(calibration_path.empty() ? false : load_plan(calibration_path, key, plan))) {
+
+        std::vector<ExecutionPlan> candidates;
+        for (std::size_t threads = 1;; threads = std::min(threads * 2, available_cpus.size())) {
+            candidates.push_back({threads, false});
+            candidates.push_back({threads, true});
+            if (threads == available_cpus.size()) {
+                break;
+            }
+        }
 
-    // Should the program prompt for user input before terminating the program? This is useful is an external console
-    // is used, as the console will close after the program terminates.
-    bool pause = false;
+        const auto calibration_start = std::chrono::steady_clock::now();
+        plan = calibrate(candidates, [&](const ExecutionPlan &candidate) {
 
-    // Stores the arguments as a vector of strings.
-    const std::vector<std::string> args(argv, argv + argc);
+            const std::vector<int> cpus = place_threads(topology, candidate.threads, physical_cores);
+            WorkerPool pool(cpus.size(), pin ? cpus : std::vector<int>());
 
-    // Loop over each argument, except for argv[0], because the program path is in argv[0].
-    for (std::size_t i = 1; i < args.size(); i++) {
-        if (args[i] == "--pause") {
-            pause = true;
+            EvolutionSettings candidate_settings = settings;
+            candidate_settings.sparse = candidate.sparse;
+            Evolution evolution(candidate_settings, population, pool, objective, seed);
+            evolution.reset(current);
+
+            // Run for at least a few generations, and until enough time has passed to measure reliably.
+            int generations = 0;
+            const auto start = std::chrono::steady_clock::now();
+            std::chrono::duration<double> elapsed{};
+            do {
+                evolution.step();
+                elapsed = std::chrono::steady_clock::now() - start;
+                generations++;
+            } while (generations < 3 || elapsed < std::chrono::milliseconds(20));
+
+            // Leave the population as it was found.
+            evolution.reset(current);
+
+            return elapsed.count() / generations;
+
+        });
+
+        const auto calibration_time = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - calibration_start);
+        plan_source = "calibrated in " + std::to_string(calibration_time.count()) + "ms";
+
+        if (!calibration_path.empty()) {
+            save_plan(calibration_path, key, plan);
         }
+
+    } else if (calibrate_plan) {
+        plan_source = "cached in " + calibration_path;
     }
 
-    // Seed the random number generator. Note, this is an old and non-uniform way to generate pseudo-random numbers, and
-    // should not be used in most cases, unless it is for a proof-of-concept or similar.
-    srand(static_cast<unsigned>(time(nullptr)));
+    // Chunked genomes only ever skip straight to the characters that mutate, whatever the arguments ask for.
+    if (chunked) {
+        plan.sparse = true;
+        plan_source = "always, with chunked genomes";
+    }
 
-    // The starting value for individuals.
-    std::string current(TARGET.length(), 0);
-    std::generate(current.begin(), current.end(), random_char);
+    const std::vector<int> cpus = place_threads(topology, plan.threads, physical_cores);
+    // The pool is replaced if the control file changes the thread count.
+    auto pool = std::make_unique<WorkerPool>(cpus.size(), pin ? cpus : std::vector<int>());
 
-    // Initializes a population.
-    std::vector<std::string> population(POPULATION_SIZE);
-    std::fill(population.begin(), population.end(), current);
+    settings.sparse = plan.sparse;
+    // Generate the first individuals, spread across the workers, and score them.
+    initializer->initialize(population, *pool, seed);
 
-    std::cout << "Population Size: " << POPULATION_SIZE << std::endl;
-    std::cout << "Mutation Chance: " << (MUTATION_CHANCE * 100) << "%" << std::endl;
+    Evolution evolution(settings, population, *pool, batch_fitness, seed);
+    evolution.restart();
+    if (!lineage_path.empty()) {
+        evolution.record_lineage(&lineage);
+    }
+
+    std::unique_ptr<SteadyStateEvolution> steady_state;
+    if (async) {
+        steady_state = std::make_unique<SteadyStateEvolution>(settings, population, *pool, batch_fitness, seed);
+        steady_state->restart();
+    }
+
+    std::unique_ptr<ChunkedEvolution> chunked_evolution;
+    if (chunked) {
+        chunked_evolution = std::make_unique<ChunkedEvolution>(settings, population_size, seed);
+        chunked_evolution->reset(current);
+    }
+
+    std::cout << "Population Size: " << population_size << std::endl;
+    if (population.mapped()) {
+        std::cout << "Population File: " << population_path << std::endl;
+    }
+    std::cout << "Threads: " << pool->size() << " (" << topology.cpus.size() << " CPUs available, "
+              << topology.cores.size() << " physical cores)" << std::endl;
+    std::cout << "Initializer: " << initializer_name << (hints_path.empty() ? "" : " (" + hints_path + ")")
+              << std::endl;
+    std::cout << "Generations: " << (async ? "Asynchronous (steady state)" : "Lockstep") << std::endl;
+    if (chunked) {
+        std::cout << "Genomes: Chunked (" << CHUNK_SIZE << " characters per chunk)" << std::endl;
+    }
+    std::cout << "Mutation Kernel: " << (plan.sparse ? "Sparse" : "Dense") << " (" << plan_source << ")" << std::endl;
+    if (pin) {
+        std::cout << "Pinned To CPUs: " << format_cpus(cpus) << std::endl;
+    }
+    std::cout << "Mutation Chance: " << (settings.mutation_chance * 100) << "%" << std::endl;
+    if (plugin.loaded()) {
+        std::cout << "Fitness Plugin: " << plugin_path << std::endl;
+    } else if (expression.compiled()) {
+        std::cout << "Fitness Expression: " << expression_source << std::endl;
+    } else {
+        std::cout << "Fitness Mode: " << (settings.fitness_mode == FitnessMode::GRADED ? "Graded" : "Exact") << std::endl;
+    }
+    if (novelty) {
+        std::cout << "Novelty Weight: " << novelty_weight << std::endl;
+    }
 
     // Get the time in which the program started.
     const auto start_time = std::chrono::high_resolution_clock::now();
 
-    int generation = 0;
-    for (;;) {
+    // The observers of the generation loop, which fire the tracepoints, draw the dashboard if it is enabled, and print
+    // every generation unless the dashboard is drawn instead. The observers chosen at run-time, such as the dashboard,
+    // come before the console, so that its last frame is drawn above the summary.
+    ProbeObserver probes;
+    Dashboard dashboard(settings.target);
+    ConsoleObserver console(std::cout, quiet || dashboard_enabled);
+    ObserverList registered;
+    if (dashboard_enabled) {
+        registered.add(dashboard);
+    }
+    ObserverSet observers(probes, registered, console);
 
-        // Increment to the next generation.
-        generation++;
+    // The allocations made by the generation loop, and the most made by any single generation.
+    const AllocationCounts loop_start_allocations = allocation_counts();
+    AllocationCounts generation_allocations = loop_start_allocations;
+    std::uint64_t most_generation_allocations = 0;
 
-        // Attempt to mutate each individual in the population.
-        std::for_each(population.begin(), population.end(), mutate);
+    // The last generation, and the outcome of the run, which is kept once the target is reached.
+    Evolution::Generation last{};
+    CachedResult outcome;
 
-        // Get the individual with the highest score.
-        const int highest_scorer = highest_scoring(population);
-        const std::string &value = population[highest_scorer];
-        const double fitness_score = fitness(value);
+    // Reports the outcome of a generation, and returns if the search should carry on.
+    const auto report = [&](const Evolution::Generation &result, const std::string_view best) {
 
-        // Output the individual with the peak fitness score.
-        std::cout << value << "  |  " << fitness_score << '\n';
+        last = result;
+        observers.generation({result, best});
 
-        // If the algorithm is done, break out of the loop.
-        if (fitness_score == 1) {
-            break;
+        // If the algorithm is done, stop.
+        if (result.solved) {
+            outcome = {std::string(best), result.number, result.score};
+            return false;
         }
 
-        // Replace each individual with the peak individual.
-        std::fill(population.begin(), population.end(), value);
+        const AllocationCounts allocations = allocation_counts();
+        most_generation_allocations = std::max(most_generation_allocations,
+                                               allocations.allocations - generation_allocations.allocations);
+        generation_allocations = allocations;
+
+        PROBE_GENERATION_START(result.number + 1);
+        return true;
+
+    };
+
+    // Applies the changes made to the control file since the last generation, if any.
+    const auto apply_control = [&]() {
+
+        ControlChanges changes;
+        if (!control.changed()) {
+            return;
+        }
+        if (const std::string message = control.read(changes); !message.empty()) {
+            std::cerr << "Failed to apply control file: " << message << std::endl;
+            return;
+        }
+
+        if (changes.mutation_chance) {
+            evolution.set_mutation_chance(*changes.mutation_chance);
+        }
+        // The dashboard owns the terminal while it is drawn, so nothing else may be printed over it.
+        if (changes.quiet && !dashboard_enabled) {
+            console.set_quiet(*changes.quiet);
+        }
+        if (changes.log_interval) {
+            console.set_interval(*changes.log_interval);
+        }
+
+        // The old workers are only stopped once the evolution has moved onto the new ones.
+        if (changes.threads) {
+            const std::vector<int> thread_cpus = place_threads(topology, *changes.threads, physical_cores);
+            if (thread_cpus.size() != pool->size()) {
+                auto resized = std::make_unique<WorkerPool>(thread_cpus.size(), pin ? thread_cpus : std::vector<int>());
+                if (dashboard_enabled) {
+                    resized->measure_busy_time();
+                    dashboard.watch(resized.get());
+                }
+                evolution.rebind(*resized);
+                pool = std::move(resized);
+            }
+        }
+
+        if (!dashboard_enabled) {
+            std::cout << "Control: mutation chance " << (evolution.settings().mutation_chance * 100) << "%, "
+                      << pool->size() << " threads" << std::endl;
+        }
+
+    };
+
+    if (dashboard_enabled) {
+        pool->measure_busy_time();
+        dashboard.watch(pool.get());
+        dashboard.start();
+    }
+
+    PROBE_GENERATION_START(1);
+    if (steady_state) {
+
+        // The workers never wait for each other, and every worker's offspring count towards the generations.
+        steady_state->run([&](const Evolution::Generation &result) {
+            return report(result, steady_state->best());
+        });
+
+    } else if (chunked_evolution) {
+
+        Evolution::Generation result;
+        do {
+            const TraceScope generation_scope("generation");
+            result = chunked_evolution->step();
+        } while (report(result, chunked_evolution->best()));
+
+    } else {
+
+        // Run each generation in lockstep, until one reaches the target. Changes to the settings are applied between
+        // generations.
+        Evolution::Generation result;
+        do {
+            apply_control();
+            const TraceScope generation_scope("generation");
+            result = evolution.step();
+        } while (report(result, evolution.best()));
 
     }
 
-    // Calculate the total time elapsed since the program started.
-    const auto end_time = std::chrono::high_resolution_clock::now();
-    const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
-    std::cout << "Time Elapsed: " << duration.count() << "ms" << std::endl;
+    // Report the total time elapsed since the program started.
+    observers.termination({last, outcome.best}, std::chrono::high_resolution_clock::now() - start_time);
 
-    std::cout << "Completed in " << generation << " generations." << std::endl;
+    if (!cache_path.empty()) {
+        cache.store(job_key, outcome);
+        cache_lock.reset();
+    }
+
+    if (!lineage_path.empty()) {
+        if (const std::string message = lineage.close(); !message.empty()) {
+            std::cerr << "Failed to write lineage log: " << message << std::endl;
+            return 1;
+        }
+        std::cout << "Lineage: " << lineage.survivors() << " survivors logged to " << lineage_path << ", "
+                  << lineage.improvements() << " of " << lineage.offspring() << " offspring improved" << std::endl;
+    }
+
+    if (memory_report) {
+
+        // Every individual costs its characters plus its error, and its score if a plugin or expression is used.
+        const std::size_t individual_bytes = population.length() + sizeof(long)
+                                             + (evolution.batch_scored() ? sizeof(double) : 0);
+        const AllocationCounts allocations = allocation_counts();
+        const std::uint64_t loop_allocations = allocations.allocations - loop_start_allocations.allocations;
+
+        if (chunked_evolution) {
+
+            // Chunked individuals cost their chunk references and their error, and share the chunks themselves.
+            const std::size_t chunk_bytes = CHUNK_SIZE + sizeof(std::uint32_t);
+            const std::size_t reference_bytes = (settings.target.length() + CHUNK_SIZE - 1) / CHUNK_SIZE
+                                                * sizeof(std::uint32_t) + sizeof(long);
+
+            std::cout << "Memory Per Individual: " << reference_bytes << " bytes, plus shared chunks" << std::endl;
+            std::cout << "Population Memory: "
+                      << reference_bytes * population_size + chunk_bytes * chunked_evolution->allocated_chunks()
+                      << " bytes (" << chunked_evolution->live_chunks() << " live chunks of "
+                      << chunked_evolution->allocated_chunks() << " allocated)" << std::endl;
+
+        } else {
+            std::cout << "Memory Per Individual: " << individual_bytes << " bytes" << std::endl;
+            std::cout << "Population Memory: " << individual_bytes * population.size() << " bytes"
+                      << (population.mapped() ? " (characters mapped from a file)" : "") << std::endl;
+        }
+        std::cout << "Peak RSS: " << peak_rss() << " bytes (" << current_rss() << " bytes now)" << std::endl;
+        std::cout << "Allocations: " << allocations.allocations << " (" << allocations.bytes << " bytes), "
+                  << allocations.live_bytes << " bytes still live" << std::endl;
+        std::cout << "Allocations In Loop: " << loop_allocations << " ("
+                  << (allocations.bytes - loop_start_allocations.bytes) << " bytes), "
+                  << static_cast<double>(loop_allocations) / last.number << " per generation, at most "
+                  << most_generation_allocations << " in one generation" << std::endl;
+
+    }
+
+    if (!trace_path.empty()) {
+        if (const std::string message = trace_write(trace_path); !message.empty()) {
+            std::cerr << "Failed to write trace: " << message << std::endl;
+        } else {
+            std::cout << "Trace: " << trace_path << std::endl;
+        }
+    }
+
+    if (novelty) {
+        std::cout << "Novelty Archive: " << novelty->archive().size() << " behaviors, "
+                  << novelty->archive().mean_candidates() << " measured per query" << std::endl;
+    }
+
+    if (surrogate) {
+        const auto total = static_cast<double>(surrogate->evaluations() + surrogate->saved());
+        std::cout << "Surrogate: " << surrogate->evaluations() << " evaluations, " << surrogate->saved() << " saved ("
+                  << (100 * static_cast<double>(surrogate->saved()) / total) << "%), mean absolute error "
+                  << surrogate->mean_absolute_error() << std::endl;
+    }
 
     if (pause) {
 
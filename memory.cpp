@@ -0,0 +1,148 @@
+#include "memory.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <malloc.h>
+#include <new>
+#include <sys/resource.h>
+#include <unistd.h>
+
+
+namespace {
+
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> frees{0};
+    std::atomic<std::uint64_t> bytes{0};
+    std::atomic<std::uint64_t> live_bytes{0};
+
+    /// Counts an allocation, returning it unchanged.
+    void *counted(void *pointer) {
+        if (pointer != nullptr) {
+            const std::uint64_t size = malloc_usable_size(pointer);
+            allocations.fetch_add(1, std::memory_order_relaxed);
+            bytes.fetch_add(size, std::memory_order_relaxed);
+            live_bytes.fetch_add(size, std::memory_order_relaxed);
+        }
+        return pointer;
+    }
+
+    /// Counts and frees an allocation.
+    void release(void *pointer) noexcept {
+        if (pointer != nullptr) {
+            frees.fetch_add(1, std::memory_order_relaxed);
+            live_bytes.fetch_sub(malloc_usable_size(pointer), std::memory_order_relaxed);
+            std::free(pointer);
+        }
+    }
+
+    void *allocate(const std::size_t size) {
+        return counted(std::malloc(size == 0 ? 1 : size));
+    }
+
+    void *allocate(const std::size_t size, const std::align_val_t alignment) {
+
+        // aligned_alloc requires the size to be a multiple of the alignment.
+        const auto align = static_cast<std::size_t>(alignment);
+        return counted(std::aligned_alloc(align, (size + align - 1) / align * align));
+
+    }
+
+}
+
+
+void *operator new(const std::size_t size) {
+    if (void *pointer = allocate(size)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](const std::size_t size) {
+    return operator new(size);
+}
+
+void *operator new(const std::size_t size, const std::nothrow_t &) noexcept {
+    return allocate(size);
+}
+
+void *operator new[](const std::size_t size, const std::nothrow_t &) noexcept {
+    return allocate(size);
+}
+
+void *operator new(const std::size_t size, const std::align_val_t alignment) {
+    if (void *pointer = allocate(size, alignment)) {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](const std::size_t size, const std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void operator delete(void *pointer) noexcept {
+    release(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+    release(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept {
+    release(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept {
+    release(pointer);
+}
+
+void operator delete(void *pointer, std::align_val_t) noexcept {
+    release(pointer);
+}
+
+void operator delete[](void *pointer, std::align_val_t) noexcept {
+    release(pointer);
+}
+
+void operator delete(void *pointer, std::size_t, std::align_val_t) noexcept {
+    release(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t, std::align_val_t) noexcept {
+    release(pointer);
+}
+
+
+AllocationCounts allocation_counts() {
+    return {
+            allocations.load(std::memory_order_relaxed),
+            frees.load(std::memory_order_relaxed),
+            bytes.load(std::memory_order_relaxed),
+            live_bytes.load(std::memory_order_relaxed)
+    };
+}
+
+
+std::uint64_t peak_rss() {
+
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+
+    // Linux reports the peak in kilobytes.
+    return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;
+
+}
+
+
+std::uint64_t current_rss() {
+
+    // The second field of statm is the resident set size, in pages.
+    std::ifstream statm("/proc/self/statm");
+    std::uint64_t size = 0;
+    std::uint64_t resident = 0;
+    statm >> size >> resident;
+
+    return resident * static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+
+}
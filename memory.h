@@ -0,0 +1,42 @@
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <cstdint>
+
+
+/**
+ * Counts of every allocation made through operator new since the program started, across all threads. The counts come
+ * from replacing the global operator new and delete, which only adds a few relaxed atomic operations to each call.
+ */
+struct AllocationCounts {
+
+    /// How many allocations were made.
+    std::uint64_t allocations = 0;
+
+    /// How many allocations were freed.
+    std::uint64_t frees = 0;
+
+    /// How many bytes were allocated in total, as reported by the allocator, which may round sizes up.
+    std::uint64_t bytes = 0;
+
+    /// How many bytes are currently allocated.
+    std::uint64_t live_bytes = 0;
+
+};
+
+/**
+ * @return The allocations made so far.
+ */
+AllocationCounts allocation_counts();
+
+/**
+ * @return The largest resident set size of the process so far, in bytes.
+ */
+std::uint64_t peak_rss();
+
+/**
+ * @return The current resident set size of the process, in bytes.
+ */
+std::uint64_t current_rss();
+
+#endif
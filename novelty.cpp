@@ -0,0 +1,194 @@
+#include "novelty.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+std::uint32_t hamming_distance(const std::uint64_t *a, const std::uint64_t *b, const std::size_t words) {
+
+    // Four independent sums keep the popcounts from waiting on each other, and let the compiler vectorize them where
+    // the target has a vector popcount.
+    std::uint32_t sums[4] = {};
+    std::size_t i = 0;
+    for (; i + 4 <= words; i += 4) {
+        for (std::size_t lane = 0; lane < 4; lane++) {
+            sums[lane] += static_cast<std::uint32_t>(__builtin_popcountll(a[i + lane] ^ b[i + lane]));
+        }
+    }
+    for (; i < words; i++) {
+        sums[0] += static_cast<std::uint32_t>(__builtin_popcountll(a[i] ^ b[i]));
+    }
+
+    return sums[0] + sums[1] + sums[2] + sums[3];
+
+}
+
+
+NoveltyArchive::NoveltyArchive(const std::size_t bits, const std::uint64_t seed)
+        : bits(bits), behavior_words((bits + 63) / 64) {
+
+    // Every table samples distinct bits, chosen by a partial shuffle of all of them.
+    Random random(stream_seed(seed, StreamPurpose::ARCHIVE_SAMPLES));
+    std::vector<std::uint32_t> positions(bits);
+    for (std::size_t i = 0; i < bits; i++) {
+        positions[i] = static_cast<std::uint32_t>(i);
+    }
+
+    const std::size_t sampled = std::min(SAMPLED_BITS, bits);
+    for (auto &sample : samples) {
+        for (std::size_t i = 0; i < sampled; i++) {
+            std::swap(positions[i], positions[i + random.below(static_cast<std::uint32_t>(bits - i))]);
+        }
+        sample.assign(positions.begin(), positions.begin() + static_cast<std::ptrdiff_t>(sampled));
+    }
+
+}
+
+
+std::uint64_t NoveltyArchive::hash(const std::size_t table, const std::uint64_t *behavior) const {
+
+    std::uint64_t key = 0;
+    for (const std::uint32_t position : samples[table]) {
+        key = key << 1 | (behavior[position / 64] >> (position % 64) & 1);
+    }
+
+    return key;
+
+}
+
+
+void NoveltyArchive::add(const std::uint64_t *behavior) {
+
+    const auto index = static_cast<std::uint32_t>(count++);
+    behaviors.insert(behaviors.end(), behavior, behavior + behavior_words);
+    stamps.push_back(0);
+
+    for (std::size_t table = 0; table < TABLES; table++) {
+        buckets[table][hash(table, behavior)].push_back(index);
+    }
+
+}
+
+
+void NoveltyArchive::consider(const std::uint32_t distance, const std::size_t neighbours) {
+
+    if (found == neighbours && distance >= nearest[found - 1]) {
+        return;
+    }
+
+    // Insert the distance in order, dropping the farthest if the list is full.
+    std::size_t i = found < neighbours ? found++ : found - 1;
+    for (; i > 0 && nearest[i - 1] > distance; i--) {
+        nearest[i] = nearest[i - 1];
+    }
+    nearest[i] = distance;
+
+}
+
+
+double NoveltyArchive::sparseness(const std::uint64_t *behavior, std::size_t neighbours) {
+
+    neighbours = std::min(neighbours, MAX_NEIGHBOURS);
+    if (count == 0 || neighbours == 0) {
+        return static_cast<double>(bits);
+    }
+
+    found = 0;
+    queries++;
+
+    if (count <= EXHAUSTIVE_LIMIT) {
+
+        // Measure every behavior, streaming through them in order.
+        for (std::size_t i = 0; i < count; i++) {
+            consider(hamming_distance(behavior, &behaviors[i * behavior_words], behavior_words), neighbours);
+        }
+        measured += count;
+
+    } else {
+
+        // Only measure the behaviors that share a bucket with the query in any table.
+        if (++query == 0) {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            query = 1;
+        }
+
+        for (std::size_t table = 0; table < TABLES; table++) {
+
+            const auto bucket = buckets[table].find(hash(table, behavior));
+            if (bucket == buckets[table].end()) {
+                continue;
+            }
+
+            for (const std::uint32_t index : bucket->second) {
+                if (stamps[index] != query) {
+                    stamps[index] = query;
+                    consider(hamming_distance(behavior, &behaviors[index * behavior_words], behavior_words),
+                             neighbours);
+                    measured++;
+                }
+            }
+
+        }
+
+    }
+
+    // Neighbours that were not found are counted as far away as possible, as do the missing ones of a small archive.
+    double total = static_cast<double>(neighbours - found) * static_cast<double>(bits);
+    for (std::size_t i = 0; i < found; i++) {
+        total += nearest[i];
+    }
+
+    return total / static_cast<double>(neighbours);
+
+}
+
+
+NoveltySearch::NoveltySearch(BatchFitness *fitness, const double weight, const std::size_t length,
+                             const FitnessMode mode, const std::uint64_t seed)
+        : objective(fitness), weight(weight), mode(mode), history(length * 8, seed),
+          random(stream_seed(seed, StreamPurpose::ARCHIVE_PICKS)) {}
+
+
+void NoveltySearch::evaluate(const Population &population, const std::string &target, std::vector<double> &scores) {
+
+    // Score fitness first, with the given fitness function or the built-in one.
+    if (objective != nullptr) {
+        objective->evaluate(population, target, scores);
+    } else {
+        scores.resize(population.size());
+        for (std::size_t i = 0; i < population.size(); i++) {
+            scores[i] = fitness(error(population.view(i), target, mode), target.length(), mode);
+        }
+    }
+
+    // The behavior of an individual is the bits of its characters, padded with zeros to a whole word.
+    const std::size_t words = history.words();
+    population_behaviors.assign(population.size() * words, 0);
+    for (std::size_t i = 0; i < population.size(); i++) {
+        std::memcpy(&population_behaviors[i * words], population[i], population.length());
+    }
+
+    // Measure novelty against the archive as it was before this generation, relative to the largest distance.
+    const auto largest = static_cast<double>(population.length() * 8);
+    novelty.resize(population.size());
+    for (std::size_t i = 0; i < population.size(); i++) {
+        novelty[i] = history.sparseness(&population_behaviors[i * words], NEIGHBOURS) / largest;
+    }
+
+    // Only an individual whose own fitness reaches the target is scored 1, so that novelty alone never ends the search.
+    const double unsolved_limit = std::nextafter(1.0, 0.0);
+    for (std::size_t i = 0; i < population.size(); i++) {
+        scores[i] = scores[i] >= 1 ? 1 : std::min((1 - weight) * scores[i] + weight * novelty[i], unsolved_limit);
+    }
+
+    // Archive the most novel individual, and a few others at random.
+    const auto most_novel = static_cast<std::size_t>(std::max_element(novelty.begin(), novelty.end())
+                                                     - novelty.begin());
+    for (std::size_t i = 0; i < population.size(); i++) {
+        if (i == most_novel || random.chance() < ARCHIVE_CHANCE) {
+            history.add(&population_behaviors[i * words]);
+        }
+    }
+
+}
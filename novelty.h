@@ -0,0 +1,179 @@
+#ifndef NOVELTY_H
+#define NOVELTY_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "batch_fitness.h"
+#include "engine.h"
+
+
+/**
+ * An archive of past behaviors in Hamming space, which finds the nearest neighbours of a behavior in sublinear time.
+ *
+ * Behaviors are bit strings. The archive is indexed with bit-sampling locality-sensitive hashing: each table hashes a
+ * behavior by a fixed random sample of its bits, so behaviors that differ in few bits usually share a bucket in at
+ * least one table. A query only measures the distance to the behaviors that share one of its buckets. While the
+ * archive is small enough, every behavior is measured instead, which is both exact and faster.
+ */
+class NoveltyArchive {
+
+public:
+
+    /// How many hash tables index the archive.
+    static constexpr std::size_t TABLES = 8;
+
+    /// How many bits each table samples.
+    static constexpr std::size_t SAMPLED_BITS = 16;
+
+    /// How many behaviors the archive holds before queries switch from measuring all of them to the hash tables.
+    static constexpr std::size_t EXHAUSTIVE_LIMIT = 2048;
+
+    /// The most neighbours a query can ask for.
+    static constexpr std::size_t MAX_NEIGHBOURS = 32;
+
+    /**
+     * @param bits The length of every behavior in bits.
+     * @param seed The seed that the sampled bits are chosen with.
+     */
+    NoveltyArchive(std::size_t bits, std::uint64_t seed);
+
+    /**
+     * Adds a behavior to the archive.
+     *
+     * @param behavior The behavior, as {@link words} 64-bit words.
+     */
+    void add(const std::uint64_t *behavior);
+
+    /**
+     * Calculates the mean distance from a behavior to its nearest neighbours in the archive. Neighbours that the
+     * hash tables did not find are counted at the largest possible distance, as the tables only miss distant ones.
+     *
+     * @param behavior The behavior, as {@link words} 64-bit words.
+     * @param neighbours How many neighbours to average over, up to {@link MAX_NEIGHBOURS}.
+     *
+     * @return The mean distance in bits, or the length of a behavior if the archive is empty.
+     */
+    double sparseness(const std::uint64_t *behavior, std::size_t neighbours);
+
+    /**
+     * @return How many behaviors the archive holds.
+     */
+    [[nodiscard]] std::size_t size() const {
+        return count;
+    }
+
+    /**
+     * @return How many 64-bit words each behavior is made of.
+     */
+    [[nodiscard]] std::size_t words() const {
+        return behavior_words;
+    }
+
+    /**
+     * @return The average amount of behaviors measured per query.
+     */
+    [[nodiscard]] double mean_candidates() const {
+        return queries == 0 ? 0 : static_cast<double>(measured) / static_cast<double>(queries);
+    }
+
+private:
+
+    /// Hashes a behavior for a table from its sampled bits.
+    [[nodiscard]] std::uint64_t hash(std::size_t table, const std::uint64_t *behavior) const;
+
+    /// Keeps the nearest distances seen by a query, in ascending order.
+    void consider(std::uint32_t distance, std::size_t neighbours);
+
+    std::size_t bits;
+    std::size_t behavior_words;
+    std::size_t count = 0;
+
+    /// Every behavior, back to back.
+    std::vector<std::uint64_t> behaviors;
+
+    /// The bits sampled by each table, and the behaviors in each of its buckets.
+    std::array<std::vector<std::uint32_t>, TABLES> samples;
+    std::array<std::unordered_map<std::uint64_t, std::vector<std::uint32_t>>, TABLES> buckets;
+
+    /// The query that last measured each behavior, so no behavior is measured twice by the same query.
+    std::vector<std::uint32_t> stamps;
+    std::uint32_t query = 0;
+
+    /// The nearest distances found by the current query.
+    std::array<std::uint32_t, MAX_NEIGHBOURS> nearest{};
+    std::size_t found = 0;
+
+    std::uint64_t queries = 0;
+    std::uint64_t measured = 0;
+
+};
+
+/**
+ * Counts the bits that differ between two behaviors.
+ *
+ * @param a The first behavior.
+ * @param b The second behavior.
+ * @param words How many 64-bit words each behavior is made of.
+ *
+ * @return The Hamming distance.
+ */
+std::uint32_t hamming_distance(const std::uint64_t *a, const std::uint64_t *b, std::size_t words);
+
+
+/**
+ * Rewards individuals for behaving unlike anything seen before, alongside or in place of their fitness score. The
+ * behavior of an individual is the bits of its characters, and its novelty is its mean distance to its nearest
+ * neighbours in an archive of past behaviors, relative to the largest possible distance.
+ *
+ * Each generation the most novel individual joins the archive, along with a few others picked at random. An individual
+ * that reaches the target is always scored 1, so the search still ends when it is found, and every other individual is
+ * scored below 1, however novel it is.
+ */
+class NoveltySearch : public BatchFitness {
+
+public:
+
+    /// How many nearest neighbours novelty is averaged over.
+    static constexpr std::size_t NEIGHBOURS = 15;
+
+    /// The chance for each other individual to join the archive every generation.
+    static constexpr double ARCHIVE_CHANCE = 0.01;
+
+    /**
+     * @param fitness The fitness function to blend novelty with, or null for the built-in one.
+     * @param weight How much of each score comes from novelty rather than fitness, within (0, 1].
+     * @param length The length of the individuals that will be scored.
+     * @param mode The mode of the built-in fitness function.
+     * @param seed The seed of the archive's hash tables and of the individuals picked for it.
+     */
+    NoveltySearch(BatchFitness *fitness, double weight, std::size_t length, FitnessMode mode, std::uint64_t seed);
+
+    void evaluate(const Population &population, const std::string &target, std::vector<double> &scores) override;
+
+    /**
+     * @return The archive of past behaviors.
+     */
+    [[nodiscard]] const NoveltyArchive &archive() const {
+        return history;
+    }
+
+private:
+
+    BatchFitness *objective;
+    const double weight;
+    const FitnessMode mode;
+    NoveltyArchive history;
+    Random random;
+
+    /// Buffers reused between generations.
+    std::vector<std::uint64_t> population_behaviors;
+    std::vector<double> novelty;
+
+};
+
+#endif
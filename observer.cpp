@@ -0,0 +1,21 @@
+#include "observer.h"
+
+#include "trace.h"
+
+
+void ConsoleObserver::print(const GenerationView &view) {
+
+    // Output the individual with the peak fitness score.
+    const TraceScope scope("logging");
+    output << view.best << "  |  " << view.result.score << '\n';
+
+}
+
+
+void ConsoleObserver::on_termination(const GenerationView &view, const std::chrono::nanoseconds elapsed) {
+
+    output << "Time Elapsed: " << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << "ms"
+           << std::endl;
+    output << "Completed in " << view.result.number << " generations." << std::endl;
+
+}
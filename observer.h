@@ -0,0 +1,260 @@
+#ifndef OBSERVER_H
+#define OBSERVER_H
+
+#include <chrono>
+#include <ostream>
+#include <string_view>
+#include <tuple>
+#include <vector>
+
+#include "engine.h"
+#include "probes.h"
+
+
+/**
+ * A read-only view of a generation as it ends, which is valid for as long as the observer is being called. Nothing is
+ * copied to make one, so an observer which needs to keep the best individual must copy it itself.
+ */
+struct GenerationView {
+
+    /// The outcome of the generation.
+    const Evolution::Generation &result;
+
+    /// The individual with the peak fitness score, which is owned by the engine.
+    std::string_view best;
+
+};
+
+
+/**
+ * Receives the events of an evolution. Every event does nothing unless overridden, so an observer only overrides the
+ * events it needs. Observers are called on the thread that runs the generation loop, and must not block it for long.
+ */
+class GenerationObserver {
+
+public:
+
+    virtual ~GenerationObserver() = default;
+
+    /**
+     * Called once every generation has ended.
+     *
+     * @param view The generation.
+     */
+    virtual void on_generation(const GenerationView &) {}
+
+    /**
+     * Called after {@link on_generation} when a generation has a higher peak fitness score than any before it,
+     * including the first generation.
+     *
+     * @param view The generation.
+     * @param previous The previous best score, or -1 before the first generation.
+     */
+    virtual void on_improvement(const GenerationView &, double) {}
+
+    /**
+     * Called once the evolution has stopped.
+     *
+     * @param view The last generation.
+     * @param elapsed The time since the first generation started.
+     */
+    virtual void on_termination(const GenerationView &, std::chrono::nanoseconds) {}
+
+};
+
+
+/**
+ * Observers which are registered at run-time, such as the dashboard when it is enabled or observers written in Python,
+ * and are called in the order they were added.
+ */
+class ObserverList final : public GenerationObserver {
+
+public:
+
+    /**
+     * @param observer The observer to call, which must outlive the list.
+     */
+    void add(GenerationObserver &observer) {
+        observers.push_back(&observer);
+    }
+
+    /**
+     * @return If no observers have been added.
+     */
+    [[nodiscard]] bool empty() const {
+        return observers.empty();
+    }
+
+    void on_generation(const GenerationView &view) override {
+        for (GenerationObserver *observer : observers) {
+            observer->on_generation(view);
+        }
+    }
+
+    void on_improvement(const GenerationView &view, const double previous) override {
+        for (GenerationObserver *observer : observers) {
+            observer->on_improvement(view, previous);
+        }
+    }
+
+    void on_termination(const GenerationView &view, const std::chrono::nanoseconds elapsed) override {
+        for (GenerationObserver *observer : observers) {
+            observer->on_termination(view, elapsed);
+        }
+    }
+
+private:
+
+    std::vector<GenerationObserver *> observers;
+
+};
+
+
+/**
+ * Prints the best individual of every generation, or of every few generations, and the time and generations taken
+ * once the evolution has stopped. The generation that reaches the target is always printed.
+ */
+class ConsoleObserver final : public GenerationObserver {
+
+public:
+
+    /**
+     * @param output The stream to print to.
+     * @param quiet If the best individual of every generation should be left out.
+     */
+    ConsoleObserver(std::ostream &output, const bool quiet) : output(output), quiet(quiet) {}
+
+    /**
+     * @param leave_out If the best individual of every generation should be left out from now on.
+     */
+    void set_quiet(const bool leave_out) {
+        quiet = leave_out;
+    }
+
+    /**
+     * @param generations How many generations pass between each one that is printed from now on, at least 1.
+     */
+    void set_interval(const std::size_t generations) {
+        interval = generations;
+    }
+
+    void on_generation(const GenerationView &view) override {
+
+        // The check stays inline, so that generations which are not printed make no call.
+        if (!quiet && (view.result.solved || static_cast<std::size_t>(view.result.number) % interval == 0)) {
+            print(view);
+        }
+
+    }
+
+    void on_termination(const GenerationView &view, std::chrono::nanoseconds elapsed) override;
+
+private:
+
+    /// Prints the best individual of a generation.
+    void print(const GenerationView &view);
+
+    std::ostream &output;
+    bool quiet;
+    std::size_t interval = 1;
+
+};
+
+
+/**
+ * Fires the USDT tracepoints of {@link probes.h} from the events, so that a tracer sees the same events as observers.
+ * The events are defined here so that they inline to the tracepoints themselves, which are nops until a tracer
+ * attaches, or to nothing at all when probes are compiled out.
+ */
+class ProbeObserver final : public GenerationObserver {
+
+public:
+
+    void on_generation([[maybe_unused]] const GenerationView &view) override {
+        PROBE_GENERATION_END(view.result.number, view.result.error, static_cast<long>(view.result.score * 1e6));
+    }
+
+    void on_improvement([[maybe_unused]] const GenerationView &view, [[maybe_unused]] const double previous) override {
+
+        // Scores are passed in parts per million, except for the -1 before the first generation.
+        PROBE_IMPROVEMENT(view.result.number, previous < 0 ? -1L : static_cast<long>(previous * 1e6),
+                          static_cast<long>(view.result.score * 1e6));
+
+    }
+
+    void on_termination([[maybe_unused]] const GenerationView &view,
+                        [[maybe_unused]] const std::chrono::nanoseconds elapsed) override {
+        PROBE_TERMINATION(view.result.number, static_cast<long long>(elapsed.count()));
+    }
+
+};
+
+
+/**
+ * Dispatches the events of an evolution to a fixed set of observers, which are known at compile time. The calls are
+ * made directly on the observers' own final types, so the events that an observer defines in its header are inlined,
+ * and an empty set compiles to nothing but the comparison which detects improvements.
+ *
+ * @tparam Observers The types of the observers.
+ */
+template<typename... Observers>
+class ObserverSet {
+
+public:
+
+    /**
+     * @param observers The observers to call, in order, which must outlive the set.
+     */
+    explicit ObserverSet(Observers &... observers) : observers(observers...) {}
+
+    /**
+     * Reports the end of a generation, and then an improvement if it has the highest peak fitness score yet.
+     *
+     * @param view The generation.
+     */
+    void generation(const GenerationView &view) {
+
+        std::apply([&](auto &... observer) {
+            (observer.on_generation(view), ...);
+        }, observers);
+
+        if (view.result.score > best_score) {
+            const double previous = best_score;
+            best_score = view.result.score;
+            std::apply([&](auto &... observer) {
+                (observer.on_improvement(view, previous), ...);
+            }, observers);
+        }
+
+    }
+
+    /**
+     * Forgets the peak fitness scores of earlier generations, such as when the evolution starts over, so that the next
+     * generation is reported as an improvement.
+     */
+    void reset() {
+        best_score = -1;
+    }
+
+    /**
+     * Reports that the evolution has stopped.
+     *
+     * @param view The last generation.
+     * @param elapsed The time since the first generation started.
+     */
+    void termination(const GenerationView &view, const std::chrono::nanoseconds elapsed) {
+        std::apply([&](auto &... observer) {
+            (observer.on_termination(view, elapsed), ...);
+        }, observers);
+    }
+
+private:
+
+    std::tuple<Observers &...> observers;
+
+    /// The highest peak fitness score of any generation so far.
+    double best_score = -1;
+
+};
+
+#endif
@@ -0,0 +1,68 @@
+#include "plugin.h"
+
+#include <algorithm>
+#include <dlfcn.h>
+
+
+FitnessPlugin::~FitnessPlugin() {
+    if (handle != nullptr) {
+        dlclose(handle);
+    }
+}
+
+
+std::string FitnessPlugin::load(const std::string &path) {
+
+    if (handle != nullptr) {
+        dlclose(handle);
+        handle = nullptr;
+        evaluate_batch = nullptr;
+    }
+
+    // Resolve every symbol up front so a broken plugin is reported before the search starts.
+    void *library = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (library == nullptr) {
+        return dlerror();
+    }
+
+    const auto abi = reinterpret_cast<decltype(&fitness_plugin_abi)>(dlsym(library, "fitness_plugin_abi"));
+    const auto evaluate = reinterpret_cast<decltype(&fitness_plugin_evaluate)>(dlsym(library, "fitness_plugin_evaluate"));
+
+    if (abi == nullptr || evaluate == nullptr) {
+        dlclose(library);
+        return path + ": missing fitness_plugin_abi or fitness_plugin_evaluate";
+    }
+
+    if (const int version = abi(); version != FITNESS_PLUGIN_ABI_VERSION) {
+        dlclose(library);
+        return path + ": built for interface version " + std::to_string(version) + ", expected "
+               + std::to_string(FITNESS_PLUGIN_ABI_VERSION);
+    }
+
+    handle = library;
+    evaluate_batch = evaluate;
+
+    return "";
+
+}
+
+
+void FitnessPlugin::evaluate(const Population &population, const std::string &target, std::vector<double> &scores) {
+
+    scores.resize(population.size());
+    genomes.resize(std::min(TILE_SIZE, population.size()));
+
+    for (std::size_t begin = 0; begin < population.size(); begin += TILE_SIZE) {
+
+        const std::size_t count = std::min(TILE_SIZE, population.size() - begin);
+
+        for (std::size_t i = 0; i < count; i++) {
+            genomes[i] = population[begin + i];
+        }
+
+        const fitness_batch batch{genomes.data(), count, target.length(), target.data(), scores.data() + begin};
+        evaluate_batch(&batch);
+
+    }
+
+}
@@ -0,0 +1,61 @@
+#ifndef PLUGIN_H
+#define PLUGIN_H
+
+#include <string>
+#include <vector>
+
+#include "batch_fitness.h"
+#include "fitness_plugin.h"
+
+
+/**
+ * A fitness function loaded from a shared object, following the interface in fitness_plugin.h.
+ */
+class FitnessPlugin : public BatchFitness {
+
+public:
+
+    FitnessPlugin() = default;
+    FitnessPlugin(const FitnessPlugin &) = delete;
+    FitnessPlugin &operator=(const FitnessPlugin &) = delete;
+    ~FitnessPlugin() override;
+
+    /**
+     * Loads a plugin, replacing any plugin that was previously loaded.
+     *
+     * @param path The path of the shared object.
+     *
+     * @return An empty string if the plugin was loaded, otherwise a description of the error.
+     */
+    std::string load(const std::string &path);
+
+    /**
+     * @return If a plugin has been loaded.
+     */
+    [[nodiscard]] bool loaded() const {
+        return handle != nullptr;
+    }
+
+    /**
+     * Scores a population, one tile of {@link TILE_SIZE} individuals at a time.
+     *
+     * @param population The individuals to score, which must all be as long as the target.
+     * @param target The target value for the mutations.
+     * @param scores The output scores, which is resized to fit the population.
+     */
+    void evaluate(const Population &population, const std::string &target, std::vector<double> &scores) override;
+
+private:
+
+    /// The handle returned by dlopen.
+    void *handle = nullptr;
+
+    /// The batch evaluation function exported by the plugin.
+    decltype(&fitness_plugin_evaluate) evaluate_batch = nullptr;
+
+    /// The pointers to each individual of the tile that is being evaluated, reused between calls.
+    std::vector<const char *> genomes;
+
+};
+
+#endif
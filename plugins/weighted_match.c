@@ -0,0 +1,39 @@
+/**
+ * An example fitness plugin that rewards matching characters, weighting letters twice as heavily as anything else.
+ *
+ * Build it with the 'weighted_match' target and run the program with '--plugin <path to the shared object>'.
+ */
+#include <ctype.h>
+
+#include "fitness_plugin.h"
+
+
+int fitness_plugin_abi(void) {
+    return FITNESS_PLUGIN_ABI_VERSION;
+}
+
+
+void fitness_plugin_evaluate(const fitness_batch *batch) {
+
+    // The weights only depend on the target, so they are shared by the whole batch.
+    double total = 0;
+    for (size_t i = 0; i < batch->length; i++) {
+        total += isalpha((unsigned char) batch->target[i]) ? 2 : 1;
+    }
+
+    for (size_t n = 0; n < batch->count; n++) {
+
+        const char *genome = batch->genomes[n];
+        double score = 0;
+
+        for (size_t i = 0; i < batch->length; i++) {
+            if (genome[i] == batch->target[i]) {
+                score += isalpha((unsigned char) batch->target[i]) ? 2 : 1;
+            }
+        }
+
+        batch->scores[n] = score / total;
+
+    }
+
+}
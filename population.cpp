@@ -0,0 +1,91 @@
+#include "population.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+
+Population::Population(const std::size_t size, const std::size_t length) {
+    resize(size, length);
+}
+
+
+Population::~Population() {
+    unmap();
+}
+
+
+void Population::unmap() {
+    if (mapping != nullptr) {
+        munmap(mapping, mapping_bytes);
+        mapping = nullptr;
+        mapping_bytes = 0;
+    }
+}
+
+
+void Population::resize(const std::size_t size, const std::size_t length) {
+
+    unmap();
+
+    memory.resize(size * length);
+    data = memory.data();
+    count = size;
+    width = length;
+
+}
+
+
+std::string Population::map(const std::string &path, const std::size_t size, const std::size_t length) {
+
+    const std::size_t bytes = size * length;
+
+    const int file = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (file < 0) {
+        return path + ": " + std::strerror(errno);
+    }
+
+    if (ftruncate(file, static_cast<off_t>(bytes)) != 0) {
+        const std::string message = path + ": " + std::strerror(errno);
+        close(file);
+        return message;
+    }
+
+    // The mapping keeps its own reference to the file, so the descriptor is not needed afterwards.
+    void *address = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_NORESERVE, file, 0);
+    close(file);
+
+    if (address == MAP_FAILED) {
+        return path + ": " + std::strerror(errno);
+    }
+
+    madvise(address, bytes, MADV_SEQUENTIAL);
+
+    unmap();
+    memory.clear();
+    memory.shrink_to_fit();
+
+    mapping = address;
+    mapping_bytes = bytes;
+    data = static_cast<char *>(address);
+    count = size;
+    width = length;
+
+    return "";
+
+}
+
+
+void Population::fill(const std::string_view individual) {
+    fill(individual, 0, count);
+}
+
+
+void Population::fill(const std::string_view individual, const std::size_t begin, const std::size_t end) {
+    for (std::size_t i = begin; i < end; i++) {
+        std::copy(individual.begin(), individual.end(), (*this)[i]);
+    }
+}
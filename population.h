@@ -0,0 +1,123 @@
+#ifndef POPULATION_H
+#define POPULATION_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+/**
+ * A population of individuals which are all the same length, stored back to back in a single buffer.
+ *
+ * The buffer either lives in memory, or is a memory-mapped file so that the population can be larger than RAM. Mapped
+ * populations are meant to be walked from the first individual to the last, which lets the kernel read ahead and
+ * write back pages as each pass streams through the file.
+ */
+class Population {
+
+public:
+
+    Population() = default;
+
+    /**
+     * Creates a population in memory.
+     *
+     * @param size How many individuals the population is comprised of.
+     * @param length The length of every individual.
+     */
+    Population(std::size_t size, std::size_t length);
+
+    Population(const Population &) = delete;
+    Population &operator=(const Population &) = delete;
+    ~Population();
+
+    /**
+     * Resizes a population in memory, reusing its buffer where possible. The individuals are left unspecified.
+     *
+     * @param size How many individuals the population is comprised of.
+     * @param length The length of every individual.
+     */
+    void resize(std::size_t size, std::size_t length);
+
+    /**
+     * Backs the population with a file, which is created or resized to fit. The individuals are left unspecified.
+     *
+     * @param path The path of the file.
+     * @param size How many individuals the population is comprised of.
+     * @param length The length of every individual.
+     *
+     * @return An empty string if the file was mapped, otherwise a description of the error.
+     */
+    std::string map(const std::string &path, std::size_t size, std::size_t length);
+
+    /**
+     * @return How many individuals the population is comprised of.
+     */
+    [[nodiscard]] std::size_t size() const {
+        return count;
+    }
+
+    /**
+     * @return The length of every individual.
+     */
+    [[nodiscard]] std::size_t length() const {
+        return width;
+    }
+
+    /**
+     * @return If the population is backed by a file.
+     */
+    [[nodiscard]] bool mapped() const {
+        return mapping != nullptr;
+    }
+
+    char *operator[](const std::size_t index) {
+        return data + index * width;
+    }
+
+    const char *operator[](const std::size_t index) const {
+        return data + index * width;
+    }
+
+    /**
+     * @return A view of an individual.
+     */
+    [[nodiscard]] std::string_view view(const std::size_t index) const {
+        return {(*this)[index], width};
+    }
+
+    /**
+     * Replaces every individual with a copy of another, in a single pass from the first individual to the last.
+     *
+     * @param individual The individual to copy, which must not point into this population.
+     */
+    void fill(std::string_view individual);
+
+    /**
+     * Replaces a range of individuals with a copy of another.
+     *
+     * @param individual The individual to copy, which must not point into this population.
+     * @param begin The index of the first individual to replace.
+     * @param end The index after the last individual to replace.
+     */
+    void fill(std::string_view individual, std::size_t begin, std::size_t end);
+
+private:
+
+    /// Releases the mapped file, if there is one.
+    void unmap();
+
+    char *data = nullptr;
+    std::size_t count = 0;
+    std::size_t width = 0;
+
+    /// The buffer when the population is in memory.
+    std::vector<char> memory;
+
+    /// The mapped file when the population is backed by one.
+    void *mapping = nullptr;
+    std::size_t mapping_bytes = 0;
+
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef PROBES_H
+#define PROBES_H
+
+/**
+ * USDT static tracepoints in the generation loop, under the 'cool_topics' provider. They can be attached to with tools
+ * such as bpftrace or perf without rebuilding, for example:
+ *
+ *     bpftrace -e 'usdt:./Cool_Topics_Project:cool_topics:improvement { printf("%d %d\n", arg0, arg2); }'
+ *
+ * A probe that nothing is attached to is a single nop, and its arguments are values the loop has already computed.
+ * Tracers timestamp every probe themselves, so the time between probes is measured by the tracer rather than the loop.
+ * Scores are passed in parts per million, as integer arguments are the most portable between tracers.
+ *
+ * The probes compile to nothing if <sys/sdt.h> is unavailable, or if COOL_TOPICS_NO_PROBES is defined.
+ */
+
+#if defined(__has_include) && !defined(COOL_TOPICS_NO_PROBES)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define COOL_TOPICS_PROBES 1
+#endif
+#endif
+
+#ifdef COOL_TOPICS_PROBES
+
+/// A generation is starting. Arguments: the generation.
+#define PROBE_GENERATION_START(generation) \
+    DTRACE_PROBE1(cool_topics, generation_start, generation)
+
+/// A generation has been selected. Arguments: the generation, the best error and the best score in parts per million.
+#define PROBE_GENERATION_END(generation, error, score) \
+    DTRACE_PROBE3(cool_topics, generation_end, generation, error, score)
+
+/// The best score has improved. Arguments: the generation, the previous best score and the new best score.
+#define PROBE_IMPROVEMENT(generation, previous, score) \
+    DTRACE_PROBE3(cool_topics, improvement, generation, previous, score)
+
+/// The search has finished. Arguments: the generation and the time since the search started in nanoseconds.
+#define PROBE_TERMINATION(generation, elapsed) \
+    DTRACE_PROBE2(cool_topics, termination, generation, elapsed)
+
+#else
+
+#define PROBE_GENERATION_START(generation) do {} while (0)
+#define PROBE_GENERATION_END(generation, error, score) do {} while (0)
+#define PROBE_IMPROVEMENT(generation, previous, score) do {} while (0)
+#define PROBE_TERMINATION(generation, elapsed) do {} while (0)
+
+#endif
+
+#endif
@@ -0,0 +1,1045 @@
+/**
+ * A Python extension module which drives the engine, written against the CPython API so that it needs nothing beyond
+ * the Python headers. The population, errors and scores are exposed through the buffer protocol, so that
+ * numpy.asarray() views them without copying, and generations run without holding the GIL.
+ *
+ *     import cool_topics, numpy
+ *     evolution = cool_topics.Evolution("Hello World", population=100, threads=2, seed=1)
+ *     generation = evolution.run_until(max_generations=10000)
+ *     print(generation.number, evolution.best)
+ *
+ * A fitness function written in Python is called once per generation with a view of the whole population, as an
+ * (individuals, length) array of bytes, and returns a score for every individual. Observers written in Python are
+ * registered with Evolution.observe(), and are told of the generations like the observers of observer.h.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "batch_fitness.h"
+#include "engine.h"
+#include "observer.h"
+#include "population.h"
+#include "threads.h"
+
+
+namespace {
+
+    /// How many generations run between checks for signals such as Ctrl+C.
+    constexpr int SIGNAL_INTERVAL = 1024;
+
+
+    /**
+     * A view of memory owned by another object, which exports it through the buffer protocol and keeps its owner
+     * alive for as long as the view is used. A writable view counts its exports in its owner, so that the owner can
+     * refuse to change the memory while Python may be writing to it.
+     */
+    struct ViewObject {
+
+        PyObject_HEAD
+
+        PyObject *owner;
+        Py_ssize_t *exports;
+        void *data;
+        const char *format;
+        Py_ssize_t item_size;
+        int dimensions;
+        Py_ssize_t shape[2];
+        Py_ssize_t strides[2];
+        bool writable;
+
+    };
+
+    int view_get_buffer(PyObject *object, Py_buffer *buffer, const int flags) {
+
+        auto *view = reinterpret_cast<ViewObject *>(object);
+        if ((flags & PyBUF_WRITABLE) && !view->writable) {
+            PyErr_SetString(PyExc_BufferError, "the view is read-only");
+            return -1;
+        }
+
+        Py_ssize_t bytes = view->item_size;
+        for (int dimension = 0; dimension < view->dimensions; dimension++) {
+            bytes *= view->shape[dimension];
+        }
+
+        buffer->buf = view->data;
+        buffer->obj = Py_NewRef(object);
+        buffer->len = bytes;
+        buffer->itemsize = view->item_size;
+        buffer->readonly = !view->writable;
+        buffer->ndim = view->dimensions;
+        buffer->format = (flags & PyBUF_FORMAT) ? const_cast<char *>(view->format) : nullptr;
+        buffer->shape = (flags & PyBUF_ND) ? view->shape : nullptr;
+        buffer->strides = (flags & PyBUF_STRIDES) ? view->strides : nullptr;
+        buffer->suboffsets = nullptr;
+        buffer->internal = nullptr;
+
+        if (view->writable) {
+            ++*view->exports;
+        }
+        return 0;
+
+    }
+
+    void view_release_buffer(PyObject *object, Py_buffer *) {
+
+        auto *view = reinterpret_cast<ViewObject *>(object);
+        if (view->writable) {
+            --*view->exports;
+        }
+
+    }
+
+    int view_traverse(PyObject *object, const visitproc visit, void *arg) {
+
+        // Views have no clear, since they count their exports within their owner and so must outlive their buffers.
+        // A cycle through a view is broken at its owner instead, which is always an evolution.
+        Py_VISIT(Py_TYPE(object));
+        Py_VISIT(reinterpret_cast<ViewObject *>(object)->owner);
+        return 0;
+
+    }
+
+    void view_dealloc(PyObject *object) {
+
+        // Instances of heap types hold a reference to their type.
+        PyTypeObject *type = Py_TYPE(object);
+        PyObject_GC_UnTrack(object);
+        Py_XDECREF(reinterpret_cast<ViewObject *>(object)->owner);
+        type->tp_free(object);
+        Py_DECREF(type);
+
+    }
+
+    PyType_Slot view_slots[] = {
+            {Py_tp_dealloc, reinterpret_cast<void *>(view_dealloc)},
+            {Py_tp_traverse, reinterpret_cast<void *>(view_traverse)},
+            {Py_bf_getbuffer, reinterpret_cast<void *>(view_get_buffer)},
+            {Py_bf_releasebuffer, reinterpret_cast<void *>(view_release_buffer)},
+            {Py_tp_doc, const_cast<char *>("Memory owned by an evolution, exported through the buffer protocol.")},
+            {0, nullptr}
+    };
+
+    PyType_Spec view_spec = {"cool_topics._View", sizeof(ViewObject), 0, Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC,
+                             view_slots};
+
+    /// The type of views, which is created when the module is.
+    PyTypeObject *view_type = nullptr;
+
+    /**
+     * Creates a memoryview of memory owned by another object.
+     *
+     * @param exports The count of writable exports within the owner, which is only needed if the view is writable.
+     *
+     * @return The memoryview, or nullptr with an exception set.
+     */
+    PyObject *make_view(PyObject *owner, void *data, const char *format, const Py_ssize_t item_size,
+                        const std::vector<Py_ssize_t> &shape, Py_ssize_t *exports) {
+
+        auto *view = PyObject_GC_New(ViewObject, view_type);
+        if (view == nullptr) {
+            return nullptr;
+        }
+
+        view->owner = Py_NewRef(owner);
+        view->exports = exports;
+        view->data = data;
+        view->format = format;
+        view->item_size = item_size;
+        view->dimensions = static_cast<int>(shape.size());
+        view->writable = exports != nullptr;
+
+        // Rows are laid out one after another, so each dimension's stride is the size of everything below it.
+        Py_ssize_t stride = item_size;
+        for (int dimension = view->dimensions - 1; dimension >= 0; dimension--) {
+            view->shape[dimension] = shape[dimension];
+            view->strides[dimension] = stride;
+            stride *= shape[dimension];
+        }
+        PyObject_GC_Track(view);
+
+        PyObject *memory = PyMemoryView_FromObject(reinterpret_cast<PyObject *>(view));
+        Py_DECREF(view);
+        return memory;
+
+    }
+
+
+    /**
+     * An exception raised by Python code that the engine called, which is kept until the generations stop, since the
+     * engine cannot carry it. The GIL must be held to capture or restore it.
+     */
+    class CapturedError {
+
+    public:
+
+        CapturedError() = default;
+
+        CapturedError(const CapturedError &) = delete;
+        CapturedError &operator=(const CapturedError &) = delete;
+
+        ~CapturedError() {
+
+            Py_XDECREF(type);
+            Py_XDECREF(value);
+            Py_XDECREF(traceback);
+
+        }
+
+        /**
+         * Takes the exception that is set.
+         */
+        void capture() {
+            PyErr_Fetch(&type, &value, &traceback);
+        }
+
+        /**
+         * @return If an exception was captured, which is kept until {@link restore}.
+         */
+        [[nodiscard]] bool failed() const {
+            return type != nullptr;
+        }
+
+        /**
+         * Raises the exception that was captured.
+         */
+        void restore() {
+
+            PyErr_Restore(type, value, traceback);
+            type = value = traceback = nullptr;
+
+        }
+
+    private:
+
+        PyObject *type = nullptr;
+        PyObject *value = nullptr;
+        PyObject *traceback = nullptr;
+
+    };
+
+
+    /**
+     * A fitness function written in Python, which scores the whole population with one call. It is only ever called
+     * from the thread running the generation, which takes the GIL for the call.
+     */
+    class PythonFitness final : public BatchFitness {
+
+    public:
+
+        PythonFitness(PyObject *function, PyObject *owner) : function(Py_NewRef(function)), owner(owner) {}
+
+        PythonFitness(const PythonFitness &) = delete;
+        PythonFitness &operator=(const PythonFitness &) = delete;
+
+        ~PythonFitness() override {
+            Py_XDECREF(function);
+        }
+
+        void evaluate(const Population &population, const std::string &, std::vector<double> &scores) override;
+
+        /**
+         * Visits the function for the garbage collector, since it may refer back to the evolution that owns it.
+         */
+        int traverse(const visitproc visit, void *arg) {
+
+            Py_VISIT(function);
+            return 0;
+
+        }
+
+        /**
+         * Releases the function, to break a reference cycle through it. Every later generation fails.
+         */
+        void clear() {
+            Py_CLEAR(function);
+        }
+
+        /**
+         * @return If the function raised an exception, which is kept until {@link restore_error}.
+         */
+        [[nodiscard]] bool failed() const {
+            return error.failed();
+        }
+
+        /**
+         * Raises the exception that the function raised. The GIL must be held.
+         */
+        void restore_error() {
+            error.restore();
+        }
+
+    private:
+
+        PyObject *function;
+
+        /// The object whose population is scored, which the views handed to the function keep alive.
+        PyObject *owner;
+
+        CapturedError error;
+
+    };
+
+    void PythonFitness::evaluate(const Population &population, const std::string &, std::vector<double> &scores) {
+
+        scores.assign(population.size(), 0);
+        if (failed()) {
+            return;
+        }
+
+        const PyGILState_STATE state = PyGILState_Ensure();
+        if (function == nullptr) {
+            PyErr_SetString(PyExc_RuntimeError, "the fitness function was released");
+            error.capture();
+            PyGILState_Release(state);
+            return;
+        }
+
+        PyObject *view = make_view(owner, const_cast<char *>(population[0]), "B", 1,
+                                   {static_cast<Py_ssize_t>(population.size()),
+                                    static_cast<Py_ssize_t>(population.length())}, nullptr);
+        PyObject *result = view == nullptr ? nullptr : PyObject_CallOneArg(function, view);
+        Py_XDECREF(view);
+
+        // Read the scores straight from a buffer of doubles, such as a float64 array, or else element by element.
+        Py_buffer buffer;
+        if (result != nullptr && PyObject_CheckBuffer(result)) {
+            if (PyObject_GetBuffer(result, &buffer, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == 0) {
+                const bool doubles = buffer.itemsize == sizeof(double) && buffer.format != nullptr
+                                     && std::string(buffer.format) == "d";
+                if (doubles && static_cast<std::size_t>(buffer.len) == scores.size() * sizeof(double)) {
+                    std::copy_n(static_cast<const double *>(buffer.buf), scores.size(), scores.begin());
+                    Py_CLEAR(result);
+                }
+                PyBuffer_Release(&buffer);
+            } else {
+                PyErr_Clear();
+            }
+        }
+
+        if (result != nullptr) {
+            PyObject *sequence = PySequence_Fast(result, "the fitness function must return a sequence of scores");
+            if (sequence != nullptr && static_cast<std::size_t>(PySequence_Fast_GET_SIZE(sequence)) != scores.size()) {
+                PyErr_SetString(PyExc_ValueError, "the fitness function must return one score per individual");
+            } else if (sequence != nullptr) {
+                for (std::size_t i = 0; i < scores.size() && !PyErr_Occurred(); i++) {
+                    scores[i] = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(sequence, i));
+                }
+            }
+            Py_XDECREF(sequence);
+            Py_DECREF(result);
+        }
+
+        // Keep the exception for the caller, since the engine cannot carry it.
+        if (PyErr_Occurred()) {
+            error.capture();
+            scores.assign(population.size(), 0);
+        }
+
+        PyGILState_Release(state);
+
+    }
+
+
+    /**
+     * An observer written in Python, whose on_generation(generation, best), on_improvement(generation, best, previous)
+     * and on_termination(generation, best, elapsed) methods are called for the events it defines. It is only ever
+     * called from the thread running the generations, which takes the GIL for each call.
+     */
+    class PythonObserver final : public GenerationObserver {
+
+    public:
+
+        /**
+         * Looks up the events that an object defines.
+         *
+         * @return The observer, or nullptr with an exception set if the object defines none of the events.
+         */
+        static std::unique_ptr<PythonObserver> create(PyObject *object);
+
+        PythonObserver(const PythonObserver &) = delete;
+        PythonObserver &operator=(const PythonObserver &) = delete;
+
+        ~PythonObserver() override {
+            clear();
+        }
+
+        void on_generation(const GenerationView &view) override {
+            call(GENERATION, view, std::nullopt);
+        }
+
+        void on_improvement(const GenerationView &view, const double previous) override {
+            call(IMPROVEMENT, view, previous);
+        }
+
+        void on_termination(const GenerationView &view, const std::chrono::nanoseconds elapsed) override {
+            call(TERMINATION, view, std::chrono::duration<double>(elapsed).count());
+        }
+
+        /**
+         * Visits the methods for the garbage collector, since they may refer back to the evolution that calls them.
+         */
+        int traverse(const visitproc visit, void *arg) {
+
+            for (PyObject *method : methods) {
+                Py_VISIT(method);
+            }
+            return 0;
+
+        }
+
+        /**
+         * Releases the methods, to break a reference cycle through them. The events are ignored from then on.
+         */
+        void clear() {
+
+            for (PyObject *&method : methods) {
+                Py_CLEAR(method);
+            }
+
+        }
+
+        /**
+         * @return If a method raised an exception, which is kept until {@link restore_error}.
+         */
+        [[nodiscard]] bool failed() const {
+            return error.failed();
+        }
+
+        /**
+         * Raises the exception that a method raised. The GIL must be held.
+         */
+        void restore_error() {
+            error.restore();
+        }
+
+    private:
+
+        /// The events, as indices into {@link methods}.
+        enum Event {
+            GENERATION,
+            IMPROVEMENT,
+            TERMINATION
+        };
+
+        PythonObserver() = default;
+
+        /**
+         * Calls the method of an event, if the observer defines it, with the generation, the best individual and the
+         * event's own argument, if any.
+         */
+        void call(Event event, const GenerationView &view, std::optional<double> argument);
+
+        /// The bound method of every event, or nullptr for those that are not defined.
+        std::array<PyObject *, 3> methods{};
+
+        CapturedError error;
+
+    };
+
+
+    /**
+     * Everything an evolution driven from Python owns, in the order it must be built.
+     */
+    struct Engine {
+
+        Population population;
+        WorkerPool pool;
+        std::unique_ptr<PythonFitness> fitness;
+        Evolution evolution;
+        Evolution::Generation last{};
+
+        /// The observers registered from Python, and the list and set which tell them of the generations.
+        std::vector<std::unique_ptr<PythonObserver>> python_observers;
+        ObserverList observer_list;
+        ObserverSet<ObserverList> observers{observer_list};
+
+        /// When the first generation since the evolution last started over began.
+        std::chrono::steady_clock::time_point started;
+
+        Engine(const EvolutionSettings &settings, const std::size_t size, const std::size_t threads,
+               std::unique_ptr<PythonFitness> python_fitness, const std::uint64_t seed)
+                : population(size, settings.target.length()), pool(threads, {}), fitness(std::move(python_fitness)),
+                  evolution(settings, population, pool, fitness.get(), seed) {}
+
+        /**
+         * Runs a single generation, and tells the observers of it, and that the evolution has stopped if it reached
+         * the target.
+         */
+        void step() {
+
+            if (last.number == 0) {
+                started = std::chrono::steady_clock::now();
+            }
+            last = evolution.step();
+
+            if (observer_list.empty() || failed()) {
+                return;
+            }
+            const GenerationView view{last, evolution.best()};
+            observers.generation(view);
+            if (last.solved) {
+                observers.termination(view, std::chrono::steady_clock::now() - started);
+            }
+
+        }
+
+        /**
+         * Starts the generation count and the observers' peak fitness score over.
+         */
+        void start_over() {
+
+            last = {};
+            observers.reset();
+
+        }
+
+        /**
+         * @return If the fitness function or an observer raised an exception, which is kept until
+         * {@link restore_error}.
+         */
+        [[nodiscard]] bool failed() const {
+            return (fitness && fitness->failed())
+                   || std::any_of(python_observers.begin(), python_observers.end(), [](const auto &observer) {
+                       return observer->failed();
+                   });
+        }
+
+        /**
+         * Raises the first exception that the fitness function or an observer raised. The GIL must be held.
+         */
+        void restore_error() {
+
+            if (fitness && fitness->failed()) {
+                fitness->restore_error();
+                return;
+            }
+            for (const std::unique_ptr<PythonObserver> &observer : python_observers) {
+                if (observer->failed()) {
+                    observer->restore_error();
+                    return;
+                }
+            }
+
+        }
+
+    };
+
+    struct EvolutionObject {
+
+        PyObject_HEAD
+
+        Engine *engine;
+
+        /// If generations are running, which is only ever read or changed while holding the GIL.
+        bool busy;
+
+        /// How many writable views of the population are exported.
+        Py_ssize_t exports;
+
+    };
+
+    PyTypeObject GenerationType;
+
+    PyStructSequence_Field generation_fields[] = {
+            {"number", "The number of the generation, starting at 1."},
+            {"error", "The error of the individual with the peak fitness score."},
+            {"score", "The peak fitness score."},
+            {"solved", "If the target has been reached."},
+            {nullptr, nullptr}
+    };
+
+    PyStructSequence_Desc generation_description = {
+            "cool_topics.Generation", "The outcome of a single generation.", generation_fields, 4
+    };
+
+    PyObject *make_generation(const Evolution::Generation &generation) {
+
+        PyObject *result = PyStructSequence_New(&GenerationType);
+        if (result == nullptr) {
+            return nullptr;
+        }
+
+        PyStructSequence_SET_ITEM(result, 0, PyLong_FromLong(generation.number));
+        PyStructSequence_SET_ITEM(result, 1, PyLong_FromLong(generation.error));
+        PyStructSequence_SET_ITEM(result, 2, PyFloat_FromDouble(generation.score));
+        PyStructSequence_SET_ITEM(result, 3, PyBool_FromLong(generation.solved));
+        return result;
+
+    }
+
+    std::unique_ptr<PythonObserver> PythonObserver::create(PyObject *object) {
+
+        static constexpr const char *NAMES[] = {"on_generation", "on_improvement", "on_termination"};
+
+        std::unique_ptr<PythonObserver> observer(new PythonObserver());
+        for (std::size_t event = 0; event < observer->methods.size(); event++) {
+            PyObject *method = PyObject_GetAttrString(object, NAMES[event]);
+            if (method == nullptr && !PyErr_ExceptionMatches(PyExc_AttributeError)) {
+                return nullptr;
+            }
+            PyErr_Clear();
+            observer->methods[event] = method;
+        }
+
+        if (std::all_of(observer->methods.begin(), observer->methods.end(), [](PyObject *method) {
+            return method == nullptr;
+        })) {
+            PyErr_SetString(PyExc_TypeError,
+                            "the observer must define on_generation, on_improvement or on_termination");
+            return nullptr;
+        }
+        return observer;
+
+    }
+
+    void PythonObserver::call(const Event event, const GenerationView &view, const std::optional<double> argument) {
+
+        // Events that are not defined never take the GIL.
+        if (methods[event] == nullptr || failed()) {
+            return;
+        }
+
+        const PyGILState_STATE state = PyGILState_Ensure();
+
+        // The method may have been released by the garbage collector while the GIL was waited for, and is held on to
+        // in case it is released during the call.
+        if (PyObject *method = Py_XNewRef(methods[event]); method != nullptr) {
+
+            PyObject *generation = make_generation(view.result);
+            PyObject *best = PyUnicode_DecodeLatin1(view.best.data(), static_cast<Py_ssize_t>(view.best.size()),
+                                                    nullptr);
+            PyObject *extra = argument ? PyFloat_FromDouble(*argument) : nullptr;
+
+            if (generation != nullptr && best != nullptr && (!argument || extra != nullptr)) {
+                Py_XDECREF(PyObject_CallFunctionObjArgs(method, generation, best, extra, nullptr));
+            }
+            Py_XDECREF(generation);
+            Py_XDECREF(best);
+            Py_XDECREF(extra);
+            Py_DECREF(method);
+
+        }
+
+        if (PyErr_Occurred()) {
+            error.capture();
+        }
+
+        PyGILState_Release(state);
+
+    }
+
+    int evolution_init(PyObject *object, PyObject *args, PyObject *kwargs) {
+
+        static const char *keywords[] = {"target", "population", "mutation_chance", "threads", "seed", "graded",
+                                         "sparse", "fitness", nullptr};
+
+        const char *target = nullptr;
+        Py_ssize_t target_length = 0;
+        Py_ssize_t size = 100;
+        double mutation_chance = 0.01;
+        Py_ssize_t threads = 1;
+        unsigned long long seed = 1;
+        int graded = 0;
+        int sparse = 0;
+        PyObject *function = Py_None;
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s#|ndnKppO", const_cast<char **>(keywords), &target,
+                                         &target_length, &size, &mutation_chance, &threads, &seed, &graded, &sparse,
+                                         &function)) {
+            return -1;
+        }
+
+        // Every character of the target must be one that mutations can produce, otherwise the search would never end.
+        const std::string target_string(target, target_length);
+        for (const char c : target_string) {
+            if (static_cast<unsigned char>(c) >= CHAR_MAX) {
+                PyErr_Format(PyExc_ValueError, "the target may only contain characters below %d", CHAR_MAX);
+                return -1;
+            }
+        }
+        if (target_string.empty() || size < 1 || threads < 1 || !(mutation_chance >= 0 && mutation_chance <= 1)) {
+            PyErr_SetString(PyExc_ValueError, "the target must not be empty, the population and threads must be at "
+                                              "least 1, and the mutation chance must be within [0, 1]");
+            return -1;
+        }
+        if (function != Py_None && !PyCallable_Check(function)) {
+            PyErr_SetString(PyExc_TypeError, "the fitness function must be callable");
+            return -1;
+        }
+
+        EvolutionSettings settings{target_string, mutation_chance};
+        settings.fitness_mode = graded ? FitnessMode::GRADED : FitnessMode::EXACT;
+        settings.sparse = sparse;
+
+        std::unique_ptr<PythonFitness> fitness;
+        if (function != Py_None) {
+            fitness = std::make_unique<PythonFitness>(function, object);
+        }
+
+        // Views of the engine may still be in use, so it is never replaced.
+        auto *self = reinterpret_cast<EvolutionObject *>(object);
+        if (self->engine != nullptr) {
+            PyErr_SetString(PyExc_RuntimeError, "the evolution is already initialized");
+            return -1;
+        }
+        self->engine = new Engine(settings, static_cast<std::size_t>(size), static_cast<std::size_t>(threads),
+                                  std::move(fitness), seed);
+
+        // Start from a single random individual drawn from the seed, as a batch job does.
+        self->engine->evolution.reset(starting_individual(target_string.length(), seed));
+
+        return 0;
+
+    }
+
+    int evolution_traverse(PyObject *object, const visitproc visit, void *arg) {
+
+        Py_VISIT(Py_TYPE(object));
+        Engine *engine = reinterpret_cast<EvolutionObject *>(object)->engine;
+        if (engine == nullptr) {
+            return 0;
+        }
+
+        if (engine->fitness) {
+            if (const int result = engine->fitness->traverse(visit, arg); result != 0) {
+                return result;
+            }
+        }
+        for (const std::unique_ptr<PythonObserver> &observer : engine->python_observers) {
+            if (const int result = observer->traverse(visit, arg); result != 0) {
+                return result;
+            }
+        }
+        return 0;
+
+    }
+
+    int evolution_clear(PyObject *object) {
+
+        Engine *engine = reinterpret_cast<EvolutionObject *>(object)->engine;
+        if (engine == nullptr) {
+            return 0;
+        }
+
+        if (engine->fitness) {
+            engine->fitness->clear();
+        }
+        for (const std::unique_ptr<PythonObserver> &observer : engine->python_observers) {
+            observer->clear();
+        }
+        return 0;
+
+    }
+
+    void evolution_dealloc(PyObject *object) {
+
+        PyTypeObject *type = Py_TYPE(object);
+        PyObject_GC_UnTrack(object);
+        delete reinterpret_cast<EvolutionObject *>(object)->engine;
+        type->tp_free(object);
+        Py_DECREF(type);
+
+    }
+
+    /**
+     * @return The engine of an evolution, or nullptr with an exception set if it was never initialized.
+     */
+    Engine *engine_of(PyObject *object) {
+
+        Engine *engine = reinterpret_cast<EvolutionObject *>(object)->engine;
+        if (engine == nullptr) {
+            PyErr_SetString(PyExc_RuntimeError, "the evolution was not initialized");
+        }
+        return engine;
+
+    }
+
+    /**
+     * @return The engine of an evolution whose generations are not running, which may be changed, or nullptr with an
+     * exception set.
+     */
+    Engine *idle_engine_of(PyObject *object) {
+
+        if (reinterpret_cast<EvolutionObject *>(object)->busy) {
+            PyErr_SetString(PyExc_RuntimeError, "the evolution is running generations on another call");
+            return nullptr;
+        }
+        return engine_of(object);
+
+    }
+
+    /**
+     * Runs generations until the target is reached, or until a number of them have run.
+     *
+     * @return The outcome of the last generation, or nullptr with an exception set.
+     */
+    PyObject *run(PyObject *object, const long max_generations) {
+
+        auto *self = reinterpret_cast<EvolutionObject *>(object);
+        Engine *engine = idle_engine_of(object);
+        if (engine == nullptr) {
+            return nullptr;
+        }
+
+        // Python could write to the population through a writable view while the generations run.
+        if (self->exports > 0) {
+            PyErr_SetString(PyExc_RuntimeError, "writable views of the population must be released before running");
+            return nullptr;
+        }
+
+        // Run without the GIL, only taking it back now and then to see if the run was interrupted. The evolution is
+        // marked as busy first, so that no other thread can change it in the meantime.
+        bool interrupted = false;
+        long generations = 0;
+        self->busy = true;
+        Py_BEGIN_ALLOW_THREADS
+        do {
+            engine->step();
+            generations++;
+            if (generations % SIGNAL_INTERVAL == 0) {
+                Py_BLOCK_THREADS
+                interrupted = PyErr_CheckSignals() < 0;
+                Py_UNBLOCK_THREADS
+            }
+        } while (!engine->last.solved && !interrupted && (max_generations <= 0 || generations < max_generations)
+                 && !engine->failed());
+        Py_END_ALLOW_THREADS
+        self->busy = false;
+
+        if (engine->failed()) {
+            engine->restore_error();
+            return nullptr;
+        }
+        return interrupted ? nullptr : make_generation(engine->last);
+
+    }
+
+    PyObject *evolution_step(PyObject *object, PyObject *) {
+        return run(object, 1);
+    }
+
+    PyObject *evolution_run_until(PyObject *object, PyObject *args, PyObject *kwargs) {
+
+        static const char *keywords[] = {"max_generations", nullptr};
+        long max_generations = 0;
+        if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|l", const_cast<char **>(keywords), &max_generations)) {
+            return nullptr;
+        }
+
+        return run(object, max_generations);
+
+    }
+
+    PyObject *evolution_reset(PyObject *object, PyObject *args) {
+
+        const char *individual = nullptr;
+        Py_ssize_t length = 0;
+        if (!PyArg_ParseTuple(args, "s#", &individual, &length)) {
+            return nullptr;
+        }
+
+        Engine *engine = idle_engine_of(object);
+        if (engine == nullptr) {
+            return nullptr;
+        }
+        if (static_cast<std::size_t>(length) != engine->population.length()) {
+            PyErr_SetString(PyExc_ValueError, "the individual must be as long as the target");
+            return nullptr;
+        }
+
+        engine->evolution.reset({individual, static_cast<std::size_t>(length)});
+        engine->start_over();
+        Py_RETURN_NONE;
+
+    }
+
+    PyObject *evolution_restart(PyObject *object, PyObject *) {
+
+        Engine *engine = idle_engine_of(object);
+        if (engine == nullptr) {
+            return nullptr;
+        }
+
+        engine->evolution.restart();
+        engine->start_over();
+        Py_RETURN_NONE;
+
+    }
+
+    PyObject *evolution_observe(PyObject *object, PyObject *observer) {
+
+        // The observers are called while the generations run, so they are only added in between.
+        Engine *engine = idle_engine_of(object);
+        if (engine == nullptr) {
+            return nullptr;
+        }
+
+        std::unique_ptr<PythonObserver> python_observer = PythonObserver::create(observer);
+        if (python_observer == nullptr) {
+            return nullptr;
+        }
+        engine->observer_list.add(*python_observer);
+        engine->python_observers.push_back(std::move(python_observer));
+        Py_RETURN_NONE;
+
+    }
+
+    PyObject *evolution_best(PyObject *object, void *) {
+
+        Engine *engine = engine_of(object);
+        if (engine == nullptr) {
+            return nullptr;
+        }
+
+        const std::string_view best = engine->evolution.best();
+        return PyUnicode_DecodeLatin1(best.data(), static_cast<Py_ssize_t>(best.size()), nullptr);
+
+    }
+
+    PyObject *evolution_population(PyObject *object, void *) {
+
+        Engine *engine = idle_engine_of(object);
+        if (engine == nullptr) {
+            return nullptr;
+        }
+
+        return make_view(object, engine->population[0], "B", 1,
+                         {static_cast<Py_ssize_t>(engine->population.size()),
+                          static_cast<Py_ssize_t>(engine->population.length())},
+                         &reinterpret_cast<EvolutionObject *>(object)->exports);
+
+    }
+
+    PyObject *evolution_errors(PyObject *object, void *) {
+
+        Engine *engine = engine_of(object);
+        if (engine == nullptr) {
+            return nullptr;
+        }
+
+        const std::vector<long> &errors = engine->evolution.individual_errors();
+        return make_view(object, const_cast<long *>(errors.data()), "l", sizeof(long),
+                         {static_cast<Py_ssize_t>(errors.size())}, nullptr);
+
+    }
+
+    PyObject *evolution_scores(PyObject *object, void *) {
+
+        Engine *engine = engine_of(object);
+        if (engine == nullptr) {
+            return nullptr;
+        }
+
+        // The scores are only allocated by the first generation, and are kept in place from then on.
+        const std::vector<double> &scores = engine->evolution.individual_scores();
+        if (scores.empty()) {
+            PyErr_SetString(PyExc_RuntimeError, "scores are only kept with a fitness function, after a generation");
+            return nullptr;
+        }
+        return make_view(object, const_cast<double *>(scores.data()), "d", sizeof(double),
+                         {static_cast<Py_ssize_t>(scores.size())}, nullptr);
+
+    }
+
+    PyObject *evolution_generation(PyObject *object, void *) {
+
+        Engine *engine = engine_of(object);
+        return engine == nullptr ? nullptr : make_generation(engine->last);
+
+    }
+
+    PyMethodDef evolution_methods[] = {
+            {"step", evolution_step, METH_NOARGS, "Runs a single generation, and returns its outcome."},
+            {"run_until", reinterpret_cast<PyCFunction>(reinterpret_cast<void (*)()>(evolution_run_until)),
+             METH_VARARGS | METH_KEYWORDS,
+             "Runs generations until the target is reached, or max_generations have run if it is above 0, and returns "
+             "the outcome of the last one. The GIL is released while the generations run."},
+            {"reset", evolution_reset, METH_VARARGS,
+             "Replaces every individual with a copy of the given one, and restarts the generation count."},
+            {"restart", evolution_restart, METH_NOARGS,
+             "Rescores the individuals already in the population, such as those written through its view, and "
+             "restarts the generation count."},
+            {"observe", evolution_observe, METH_O,
+             "Registers an observer, whose on_generation(generation, best), on_improvement(generation, best, previous) "
+             "and on_termination(generation, best, elapsed) methods are called for the events it defines. Observers "
+             "are called in the order they were registered, and an exception raised by one stops the generations."},
+            {nullptr, nullptr, 0, nullptr}
+    };
+
+    PyGetSetDef evolution_properties[] = {
+            {"best", evolution_best, nullptr, "The individual with the peak fitness score.", nullptr},
+            {"population", evolution_population, nullptr,
+             "A writable (individuals, length) view of the population's bytes, which must be released before "
+             "generations run.", nullptr},
+            {"errors", evolution_errors, nullptr, "A read-only view of every individual's error.", nullptr},
+            {"scores", evolution_scores, nullptr,
+             "A read-only view of every individual's score from a fitness function.", nullptr},
+            {"generation", evolution_generation, nullptr, "The outcome of the latest generation.", nullptr},
+            {nullptr, nullptr, nullptr, nullptr, nullptr}
+    };
+
+    PyType_Slot evolution_slots[] = {
+            {Py_tp_new, reinterpret_cast<void *>(PyType_GenericNew)},
+            {Py_tp_init, reinterpret_cast<void *>(evolution_init)},
+            {Py_tp_dealloc, reinterpret_cast<void *>(evolution_dealloc)},
+            {Py_tp_traverse, reinterpret_cast<void *>(evolution_traverse)},
+            {Py_tp_clear, reinterpret_cast<void *>(evolution_clear)},
+            {Py_tp_methods, evolution_methods},
+            {Py_tp_getset, evolution_properties},
+            {Py_tp_doc, const_cast<char *>(
+                    "Evolution(target, population=100, mutation_chance=0.01, threads=1, seed=1, graded=False, "
+                    "sparse=False, fitness=None)\n\nEvolves a population towards a target. A fitness function, if "
+                    "given, is called with a view of the population and returns a score per individual.")},
+            {0, nullptr}
+    };
+
+    PyType_Spec evolution_spec = {"cool_topics.Evolution", sizeof(EvolutionObject), 0,
+                                  Py_TPFLAGS_DEFAULT | Py_TPFLAGS_HAVE_GC, evolution_slots};
+
+    PyModuleDef module = {
+            PyModuleDef_HEAD_INIT, "cool_topics", "Bindings for the genetic algorithm engine.", -1, nullptr, nullptr,
+            nullptr, nullptr, nullptr
+    };
+
+}
+
+
+PyMODINIT_FUNC PyInit_cool_topics() {
+
+    view_type = reinterpret_cast<PyTypeObject *>(PyType_FromSpec(&view_spec));
+    PyObject *evolution_type = PyType_FromSpec(&evolution_spec);
+    if (view_type == nullptr || evolution_type == nullptr
+        || PyStructSequence_InitType2(&GenerationType, &generation_description) < 0) {
+        Py_XDECREF(evolution_type);
+        return nullptr;
+    }
+
+    PyObject *result = PyModule_Create(&module);
+    if (result == nullptr) {
+        Py_DECREF(evolution_type);
+        return nullptr;
+    }
+
+    auto *generation_type = reinterpret_cast<PyObject *>(&GenerationType);
+    const bool added = PyModule_AddObjectRef(result, "Evolution", evolution_type) == 0
+                       && PyModule_AddObjectRef(result, "Generation", generation_type) == 0;
+    Py_DECREF(evolution_type);
+    if (!added) {
+        Py_DECREF(result);
+        return nullptr;
+    }
+
+    return result;
+
+}
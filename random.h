@@ -0,0 +1,119 @@
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+
+/**
+ * Scrambles a value with the finalizer of splitmix64, so that consecutive values give unrelated results.
+ *
+ * @param value The value to scramble.
+ *
+ * @return The scrambled value.
+ */
+inline std::uint64_t splitmix64(std::uint64_t value) {
+
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+
+}
+
+
+/// What a random stream is drawn for, which keeps apart the streams of different purposes that share an index.
+enum class StreamPurpose : std::uint64_t {
+
+    /// The starting individual of a run.
+    START = 1,
+
+    /// Mutation, with a stream per worker.
+    MUTATION,
+
+    /// The first individuals, with a stream per individual, or per position for the order of a position's strata.
+    INITIALIZATION,
+    STRATA,
+
+    /// The bits sampled by the hash tables of a novelty archive, and the individuals picked for it.
+    ARCHIVE_SAMPLES,
+    ARCHIVE_PICKS,
+
+    /// The individuals that a surrogate evaluates to explore, rather than because it ranked them highly.
+    EXPLORATION
+
+};
+
+/**
+ * Derives the seed of a random stream from the seed of a run, so that no stream replays or correlates with another.
+ *
+ * @param seed The seed of the run.
+ * @param purpose What the stream is drawn for.
+ * @param index The index of the stream among those of the same purpose, such as a worker or an individual.
+ *
+ * @return The seed of the stream.
+ */
+inline std::uint64_t stream_seed(const std::uint64_t seed, const StreamPurpose purpose, const std::uint64_t index = 0) {
+    return splitmix64(splitmix64(seed ^ splitmix64(static_cast<std::uint64_t>(purpose))) + index);
+}
+
+
+/**
+ * A small pseudo-random number generator (xorshift64*), so that every thread can have its own stream instead of sharing
+ * the global state behind rand().
+ */
+class Random {
+
+public:
+
+    /**
+     * @param seed The seed of the stream. Streams with different seeds are independent.
+     */
+    explicit Random(const std::uint64_t seed = 1) {
+        reseed(seed);
+    }
+
+    /**
+     * Restarts the stream from a seed.
+     *
+     * @param seed The seed of the stream.
+     */
+    void reseed(const std::uint64_t seed) {
+
+        // Scramble the seed, so that consecutive seeds give unrelated streams and 0 is never the state.
+        state = splitmix64(seed) | 1;
+
+    }
+
+    /**
+     * @return The next 64 random bits.
+     */
+    std::uint64_t next() {
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        return state * 0x2545F4914F6CDD1DULL;
+    }
+
+    /**
+     * @return A random double within [0, 1).
+     */
+    double chance() {
+        return static_cast<double>(next() >> 11) * 0x1.0p-53;
+    }
+
+    /**
+     * @param bound The exclusive upper bound, which must be positive.
+     *
+     * @return A random integer within [0, bound).
+     */
+    std::uint32_t below(const std::uint32_t bound) {
+        return static_cast<std::uint32_t>(((next() >> 32) * bound) >> 32);
+    }
+
+private:
+
+    std::uint64_t state = 1;
+
+};
+
+#endif
@@ -0,0 +1,284 @@
+#include "steady_state.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+#include "trace.h"
+
+
+SteadyStateEvolution::SteadyStateEvolution(EvolutionSettings settings, Population &population, WorkerPool &pool,
+                                           BatchFitness *batch_fitness, const std::uint64_t seed)
+        : evolution_settings(std::move(settings)), population(population), pool(pool), batch_fitness(batch_fitness),
+          workers(pool.size()), slots(new std::atomic<std::uint64_t>[population.size()]) {
+
+    for (std::size_t i = 0; i < workers.size(); i++) {
+        workers[i].random.reseed(stream_seed(seed, StreamPurpose::MUTATION, i));
+        workers[i].child.resize(evolution_settings.target.length());
+        if (batch_fitness != nullptr) {
+            workers[i].scratch.resize(1, evolution_settings.target.length());
+        }
+    }
+
+    elite.reserve(evolution_settings.target.length());
+
+}
+
+
+std::uint32_t SteadyStateEvolution::rank_error(const long error) {
+    return UINT32_MAX - static_cast<std::uint32_t>(std::min<long>(error, UINT32_MAX));
+}
+
+
+std::uint32_t SteadyStateEvolution::rank_score(const double score) {
+
+    const float clamped = std::clamp(static_cast<float>(score), 0.0F, 1.0F);
+
+    std::uint32_t bits;
+    std::memcpy(&bits, &clamped, sizeof(bits));
+
+    return bits;
+
+}
+
+
+void SteadyStateEvolution::reset(const std::string_view individual) {
+
+    population.fill(individual);
+
+    std::uint32_t rank;
+    if (batch_fitness != nullptr) {
+        Worker &worker = workers.front();
+        worker.scratch.fill(individual);
+        batch_fitness->evaluate(worker.scratch, evolution_settings.target, worker.scores);
+        rank = rank_score(worker.scores.front());
+    } else {
+        rank = rank_error(error(individual, evolution_settings.target, evolution_settings.fitness_mode));
+    }
+
+    for (std::size_t i = 0; i < population.size(); i++) {
+        slots[i].store(static_cast<std::uint64_t>(rank) << 32, std::memory_order_relaxed);
+    }
+    best_slot.store(static_cast<std::uint64_t>(rank) << 32, std::memory_order_relaxed);
+
+    produced.store(0, std::memory_order_relaxed);
+    inserted.store(0, std::memory_order_relaxed);
+    solved.store(false, std::memory_order_relaxed);
+    elite = individual;
+
+}
+
+
+void SteadyStateEvolution::restart() {
+
+    std::vector<double> scores;
+    if (batch_fitness != nullptr) {
+        batch_fitness->evaluate(population, evolution_settings.target, scores);
+    }
+
+    std::uint64_t best = 0;
+    for (std::size_t i = 0; i < population.size(); i++) {
+
+        const std::uint32_t rank = batch_fitness != nullptr
+                                   ? rank_score(scores[i])
+                                   : rank_error(error(population.view(i), evolution_settings.target,
+                                                      evolution_settings.fitness_mode));
+        const std::uint64_t packed = static_cast<std::uint64_t>(rank) << 32;
+
+        slots[i].store(packed, std::memory_order_relaxed);
+        best = std::max(best, packed | i);
+
+    }
+    best_slot.store(best, std::memory_order_relaxed);
+
+    produced.store(0, std::memory_order_relaxed);
+    inserted.store(0, std::memory_order_relaxed);
+    solved.store(false, std::memory_order_relaxed);
+    elite = population.view(static_cast<std::uint32_t>(best));
+
+}
+
+
+std::uint64_t SteadyStateEvolution::copy(const std::size_t index, char *into) const {
+
+    const std::size_t length = population.length();
+
+    // A few attempts are enough, as an individual is only written when a better child replaces it.
+    for (int attempt = 0; attempt < 4; attempt++) {
+
+        const std::uint64_t before = slots[index].load(std::memory_order_acquire);
+        if ((before & WRITING) != 0) {
+            continue;
+        }
+
+        // The copy may race with a writer, in which case the version will have changed and the copy is discarded.
+        std::memcpy(into, population[index], length);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slots[index].load(std::memory_order_relaxed) == before) {
+            return before;
+        }
+
+    }
+
+    return WRITING;
+
+}
+
+
+bool SteadyStateEvolution::insert(const std::size_t index, const char *child, const std::uint32_t rank) {
+
+    std::uint64_t state = slots[index].load(std::memory_order_acquire);
+    if ((state & WRITING) != 0 || (state >> 32) >= rank) {
+        return false;
+    }
+
+    // Claim the slot, which fails if another worker replaced the individual since it was read.
+    if (!slots[index].compare_exchange_strong(state, state | WRITING, std::memory_order_acquire)) {
+        return false;
+    }
+
+    std::memcpy(population[index], child, population.length());
+
+    // Publish the child with the next even version.
+    const auto version = static_cast<std::uint32_t>(state) + 2;
+    slots[index].store(static_cast<std::uint64_t>(rank) << 32 | version, std::memory_order_release);
+
+    // Raise the best individual if the child outranks it.
+    const std::uint64_t packed = static_cast<std::uint64_t>(rank) << 32 | index;
+    std::uint64_t best = best_slot.load(std::memory_order_relaxed);
+    while ((best >> 32) < rank && !best_slot.compare_exchange_weak(best, packed, std::memory_order_relaxed)) {
+    }
+
+    return true;
+
+}
+
+
+bool SteadyStateEvolution::breed(Worker &worker) {
+
+    Random &random = worker.random;
+    const auto size = static_cast<std::uint32_t>(population.size());
+
+    // Pick the better of two individuals as the parent.
+    std::size_t parent = random.below(size);
+    if (const std::size_t other = random.below(size);
+        slots[other].load(std::memory_order_relaxed) >> 32 > slots[parent].load(std::memory_order_relaxed) >> 32) {
+        parent = other;
+    }
+
+    if ((copy(parent, worker.child.data()) & WRITING) != 0) {
+        return false;
+    }
+
+    long child_error = error(worker.child, evolution_settings.target, evolution_settings.fitness_mode);
+    const int mutations = evolution_settings.sparse
+                          ? mutate_sparse(worker.child.data(), child_error, random, evolution_settings)
+                          : mutate(worker.child.data(), child_error, random, evolution_settings);
+
+    // A child without mutations is a copy of its parent, and cannot outrank anything the parent could not.
+    if (mutations == 0) {
+        return false;
+    }
+
+    std::uint32_t rank;
+    bool reached;
+    if (batch_fitness != nullptr) {
+
+        worker.scratch.fill(worker.child);
+        if (batch_fitness->reentrant()) {
+            batch_fitness->evaluate(worker.scratch, evolution_settings.target, worker.scores);
+        } else {
+            const std::lock_guard<std::mutex> lock(evaluation_mutex);
+            batch_fitness->evaluate(worker.scratch, evolution_settings.target, worker.scores);
+        }
+
+        rank = rank_score(worker.scores.front());
+        reached = worker.scores.front() >= 1;
+
+    } else {
+        rank = rank_error(child_error);
+        reached = child_error == 0;
+    }
+
+    // Replace the worse of two individuals, if the child outranks it.
+    std::size_t victim = random.below(size);
+    if (const std::size_t other = random.below(size);
+        slots[other].load(std::memory_order_relaxed) >> 32 < slots[victim].load(std::memory_order_relaxed) >> 32) {
+        victim = other;
+    }
+
+    if (insert(victim, worker.child.data(), rank)) {
+        inserted.fetch_add(1, std::memory_order_relaxed);
+        return reached;
+    }
+
+    return false;
+
+}
+
+
+Evolution::Generation SteadyStateEvolution::progress(const bool reached) {
+
+    // The best individual only ever improves, so a copy that keeps racing with writers is only retried.
+    const std::uint64_t best = best_slot.load(std::memory_order_acquire);
+    const auto index = static_cast<std::size_t>(static_cast<std::uint32_t>(best));
+    while ((copy(index, elite.data()) & WRITING) != 0) {
+    }
+
+    const long elite_error = error(elite, evolution_settings.target, evolution_settings.fitness_mode);
+
+    double score;
+    if (batch_fitness != nullptr) {
+        float value;
+        const auto bits = static_cast<std::uint32_t>(best >> 32);
+        std::memcpy(&value, &bits, sizeof(value));
+        score = value;
+    } else {
+        score = fitness(elite_error, elite.length(), evolution_settings.fitness_mode);
+    }
+
+    const auto generation = static_cast<int>(produced.load(std::memory_order_relaxed) / population.size());
+
+    return {generation, elite_error, score, reached};
+
+}
+
+
+Evolution::Generation SteadyStateEvolution::run(const std::function<bool(const Evolution::Generation &)> &report) {
+
+    elite.resize(evolution_settings.target.length());
+    stopping.store(false, std::memory_order_relaxed);
+
+    pool.run([&](const std::size_t index) {
+
+        const TraceScope scope("steady state");
+        Worker &worker = workers[index];
+        std::uint64_t next_report = produced.load(std::memory_order_relaxed) + population.size();
+
+        while (!solved.load(std::memory_order_relaxed) && !stopping.load(std::memory_order_relaxed)) {
+
+            if (breed(worker)) {
+                solved.store(true, std::memory_order_relaxed);
+            }
+
+            const std::uint64_t count = produced.fetch_add(1, std::memory_order_relaxed) + 1;
+
+            // Only the calling thread reports, while every other worker carries on.
+            if (index == 0 && count >= next_report) {
+                next_report = count - count % population.size() + population.size();
+                if (!report(progress(false))) {
+                    stopping.store(true, std::memory_order_relaxed);
+                }
+            }
+
+        }
+
+    });
+
+    const Evolution::Generation result = progress(solved.load(std::memory_order_relaxed));
+    report(result);
+
+    return result;
+
+}
@@ -0,0 +1,165 @@
+#ifndef STEADY_STATE_H
+#define STEADY_STATE_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "engine.h"
+
+
+/**
+ * Evolves a population towards a target without generations. Every worker repeatedly picks a parent from the shared
+ * population, mutates a copy of it and scores the copy, then tries to insert it in place of a worse individual. No
+ * worker ever waits for another, so a slow evaluation only holds up the worker running it.
+ *
+ * Each individual has a slot state which packs its rank with a version, and is claimed with a compare-and-swap before
+ * the individual is replaced, like a sequence lock. Readers copy an individual without claiming it, and retry if its
+ * version changed while they copied. A child only replaces an individual that it outranks, so the best individual is
+ * never lost. The best individual is tracked by a single compare-and-swap on its packed rank and index.
+ *
+ * The progress of the search is reported every {@link Population::size} offspring, which is counted as a generation
+ * so that both engines can be compared.
+ */
+class SteadyStateEvolution {
+
+public:
+
+    /**
+     * @param settings The settings of the evolution.
+     * @param population The population to evolve, whose individuals must be as long as the target.
+     * @param pool The workers which produce offspring.
+     * @param batch_fitness A fitness function to use in place of the built-in one, if any. Unless it is reentrant, its
+     *                      evaluations are serialized.
+     * @param seed The seed of the random number generators, one per worker.
+     */
+    SteadyStateEvolution(EvolutionSettings settings, Population &population, WorkerPool &pool,
+                         BatchFitness *batch_fitness, std::uint64_t seed);
+
+    /**
+     * Replaces every individual with a copy of the same individual, and restarts the offspring count.
+     *
+     * @param individual The individual to copy.
+     */
+    void reset(std::string_view individual);
+
+    /**
+     * Restarts the offspring count from the individuals already in the population, scoring each of them.
+     */
+    void restart();
+
+    /**
+     * Produces offspring on every worker until the target is reached, or until the report asks to stop. The report is
+     * always called on the calling thread, which is also worker 0, and the other workers carry on while it runs.
+     *
+     * @param report Called with the progress of the search every generation, and once more at the end. Returns false
+     *               to stop the search.
+     *
+     * @return The progress of the search when it stopped.
+     */
+    Evolution::Generation run(const std::function<bool(const Evolution::Generation &)> &report);
+
+    /**
+     * @return The individual with the peak fitness score at the latest report.
+     */
+    [[nodiscard]] std::string_view best() const {
+        return elite;
+    }
+
+    /**
+     * @return How many offspring were produced.
+     */
+    [[nodiscard]] std::uint64_t offspring() const {
+        return produced.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @return How many offspring replaced an individual in the population.
+     */
+    [[nodiscard]] std::uint64_t insertions() const {
+        return inserted.load(std::memory_order_relaxed);
+    }
+
+private:
+
+    /// The state of a worker, padded to a cache line so that workers do not contend over them.
+    struct alignas(64) Worker {
+        Random random;
+        std::string child;
+
+        /// A population of one individual, so that a batch fitness function can score the child.
+        Population scratch;
+        std::vector<double> scores;
+    };
+
+    /// The version bit that marks a slot as being written.
+    static constexpr std::uint64_t WRITING = 1;
+
+    /**
+     * Converts an error into a rank, where a higher rank is a better individual.
+     */
+    static std::uint32_t rank_error(long error);
+
+    /**
+     * Converts a score within [0, 1] into a rank, relying on non-negative floats ordering like their bits.
+     */
+    static std::uint32_t rank_score(double score);
+
+    /**
+     * Produces, scores and inserts a single child.
+     *
+     * @return If the child reached the target.
+     */
+    bool breed(Worker &worker);
+
+    /**
+     * Copies an individual that is consistent with its slot state.
+     *
+     * @return The state of the slot that was copied, or a state with the writing bit set if it kept changing.
+     */
+    std::uint64_t copy(std::size_t index, char *into) const;
+
+    /**
+     * Replaces an individual if the child outranks it.
+     *
+     * @return If the child was inserted.
+     */
+    bool insert(std::size_t index, const char *child, std::uint32_t rank);
+
+    /**
+     * Builds the progress of the search, copying the best individual into {@link elite}.
+     */
+    Evolution::Generation progress(bool solved);
+
+    EvolutionSettings evolution_settings;
+    Population &population;
+    WorkerPool &pool;
+    BatchFitness *batch_fitness;
+
+    /// Serializes evaluations when the batch fitness function is not reentrant.
+    std::mutex evaluation_mutex;
+
+    std::vector<Worker> workers;
+
+    /// The rank of each individual in the upper 32 bits, and its version in the lower 32.
+    std::unique_ptr<std::atomic<std::uint64_t>[]> slots;
+
+    /// The rank of the best individual in the upper 32 bits, and its index in the lower 32.
+    alignas(64) std::atomic<std::uint64_t> best_slot{0};
+
+    alignas(64) std::atomic<std::uint64_t> produced{0};
+    std::atomic<std::uint64_t> inserted{0};
+    std::atomic<bool> solved{false};
+    std::atomic<bool> stopping{false};
+
+    /// A copy of the individual with the peak fitness score.
+    std::string elite;
+
+};
+
+#endif
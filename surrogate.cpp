@@ -0,0 +1,149 @@
+#include "surrogate.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+SurrogateScreen::SurrogateScreen(BatchFitness &fitness, const double fraction, const std::size_t length,
+                                 const std::uint64_t seed)
+        : fitness(fitness), fraction(fraction), random(stream_seed(seed, StreamPurpose::EXPLORATION)), weights(length),
+          optimistic(length, 0) {
+
+    for (auto &position : weights) {
+        position.fill(std::numeric_limits<double>::quiet_NaN());
+    }
+
+}
+
+
+double SurrogateScreen::weight(const std::size_t position, const char c) const {
+    const double value = weights[position][static_cast<unsigned char>(c)];
+    return std::isnan(value) ? optimistic[position] : value;
+}
+
+
+double SurrogateScreen::predict(const std::string_view individual) const {
+
+    if (best.empty()) {
+        return 0;
+    }
+
+    // Start from the best individual, and add the gain of every character that differs from it.
+    double prediction = best_score;
+
+    for (std::size_t i = 0; i < individual.length(); i++) {
+        if (individual[i] != best[i]) {
+            prediction += weight(i, individual[i]) - weight(i, best[i]);
+        }
+    }
+
+    return prediction;
+
+}
+
+
+void SurrogateScreen::train(const std::string_view individual, const double error) {
+
+    if (best.empty()) {
+        return;
+    }
+
+    std::size_t differences = 0;
+    for (std::size_t i = 0; i < individual.length(); i++) {
+        differences += individual[i] != best[i];
+    }
+
+    if (differences == 0) {
+        return;
+    }
+
+    // Normalized least mean squares over the differing characters only, so the error is blamed on the mutations.
+    const double step = LEARNING_RATE * error / static_cast<double>(2 * differences);
+
+    for (std::size_t i = 0; i < individual.length(); i++) {
+        if (individual[i] != best[i]) {
+            weights[i][static_cast<unsigned char>(individual[i])] = weight(i, individual[i]) + step;
+            weights[i][static_cast<unsigned char>(best[i])] = weight(i, best[i]) - step;
+        }
+    }
+
+}
+
+
+void SurrogateScreen::evaluate(const Population &population, const std::string &target,
+                               std::vector<double> &scores) {
+
+    generation++;
+
+    scores.assign(population.size(), -std::numeric_limits<double>::infinity());
+    predictions.resize(population.size());
+    order.clear();
+
+    for (std::size_t i = 0; i < population.size(); i++) {
+
+        // Copies of the best individual already have a known score, which also keeps it from being lost.
+        if (population.view(i) == best) {
+            scores[i] = best_score;
+            skipped++;
+            continue;
+        }
+
+        predictions[i] = predict(population.view(i));
+        order.push_back(i);
+
+    }
+
+    // Rank the rest of the population by its predicted score, keeping everyone while the model is still warming up.
+    const std::size_t keep = generation <= WARMUP_GENERATIONS
+                             ? order.size()
+                             : std::min(order.size(), static_cast<std::size_t>(std::ceil(fraction * population.size())));
+
+    std::partial_sort(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(keep), order.end(),
+                      [&](const std::size_t a, const std::size_t b) { return predictions[a] > predictions[b]; });
+
+    // Give some of the places to individuals at random, so that a character the model has wrongly learnt to dislike
+    // can still be evaluated and corrected.
+    const auto explore = static_cast<std::size_t>(EXPLORATION * static_cast<double>(keep));
+    for (std::size_t i = keep - explore; i < keep && order.size() > keep; i++) {
+        std::swap(order[i], order[keep + random.below(static_cast<std::uint32_t>(order.size() - keep))]);
+    }
+
+    // Only the candidates are handed to the real fitness function.
+    candidates.resize(keep, population.length());
+    for (std::size_t i = 0; i < keep; i++) {
+        std::copy_n(population[order[i]], population.length(), candidates[i]);
+    }
+    fitness.evaluate(candidates, target, candidate_scores);
+
+    for (std::size_t i = 0; i < keep; i++) {
+
+        absolute_error += std::abs(candidate_scores[i] - predictions[order[i]]);
+        checked++;
+
+        // The error is measured again, as the model has already moved towards the candidates before this one.
+        train(candidates.view(i), candidate_scores[i] - predict(candidates.view(i)));
+        scores[order[i]] = candidate_scores[i];
+
+        if (candidate_scores[i] > best_score) {
+            best = candidates.view(i);
+            best_score = candidate_scores[i];
+        }
+
+    }
+
+    // Refresh the predictions for unseen characters now that the weights have moved.
+    for (std::size_t i = 0; i < weights.size(); i++) {
+
+        double highest = -std::numeric_limits<double>::infinity();
+        for (const double weight : weights[i]) {
+            highest = std::isnan(weight) ? highest : std::max(highest, weight);
+        }
+        optimistic[i] = std::isinf(highest) ? 0 : highest;
+
+    }
+
+    evaluated += keep;
+    skipped += order.size() - keep;
+
+}
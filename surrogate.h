@@ -0,0 +1,126 @@
+#ifndef SURROGATE_H
+#define SURROGATE_H
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "batch_fitness.h"
+#include "random.h"
+
+
+/**
+ * Screens a population with a cheap surrogate model before scoring it with an expensive fitness function, so that only
+ * the most promising fraction of the population is truly evaluated.
+ *
+ * The surrogate is a linear model with a weight for every character at every position, which is trained online from
+ * the individuals that are truly evaluated. Predictions start from the best individual evaluated so far and add the
+ * weights of the characters that differ from it, so each error is blamed on the mutations that caused it. A character
+ * that has never been seen at a position is predicted to be as good as the best character seen there, otherwise the
+ * model would screen out exactly the novel mutations that the search depends on.
+ *
+ * Individuals that are screened out are scored as negative infinity, so they are never selected. Copies of the best
+ * individual are given its score without being evaluated.
+ */
+class SurrogateScreen : public BatchFitness {
+
+public:
+
+    /// How many generations evaluate the whole population while the model learns, before screening begins.
+    static constexpr int WARMUP_GENERATIONS = 20;
+
+    /// The fraction of the evaluated individuals that are picked at random rather than by the model.
+    static constexpr double EXPLORATION = 0.25;
+
+    /// How quickly the model follows its errors.
+    static constexpr double LEARNING_RATE = 0.5;
+
+    /**
+     * @param fitness The expensive fitness function.
+     * @param fraction The fraction of the population that is truly evaluated each generation, within (0, 1].
+     * @param length The length of the individuals that will be scored.
+     * @param seed The seed of the individuals picked to explore.
+     */
+    SurrogateScreen(BatchFitness &fitness, double fraction, std::size_t length, std::uint64_t seed);
+
+    void evaluate(const Population &population, const std::string &target, std::vector<double> &scores) override;
+
+    /**
+     * @return How many individuals were truly evaluated.
+     */
+    [[nodiscard]] std::uint64_t evaluations() const {
+        return evaluated;
+    }
+
+    /**
+     * @return How many evaluations were skipped because the surrogate screened the individual out.
+     */
+    [[nodiscard]] std::uint64_t saved() const {
+        return skipped;
+    }
+
+    /**
+     * @return The mean absolute error of the surrogate's predictions, measured on each evaluated individual before the
+     * model was trained on it.
+     */
+    [[nodiscard]] double mean_absolute_error() const {
+        return checked == 0 ? 0 : absolute_error / static_cast<double>(checked);
+    }
+
+private:
+
+    /**
+     * @return The weight of a character at a position, which is the optimistic weight if it has never been seen.
+     */
+    [[nodiscard]] double weight(std::size_t position, char c) const;
+
+    /**
+     * Predicts the score of an individual.
+     *
+     * @param individual The individual to predict the score of.
+     *
+     * @return The predicted score.
+     */
+    [[nodiscard]] double predict(std::string_view individual) const;
+
+    /**
+     * Moves the model towards the true score of an individual.
+     *
+     * @param individual The individual that was evaluated.
+     * @param error The true score minus the predicted score.
+     */
+    void train(std::string_view individual, double error);
+
+    BatchFitness &fitness;
+    const double fraction;
+    Random random;
+
+    /// The weight of each character at each position, which is NaN until the character is seen there.
+    std::vector<std::array<double, 256>> weights;
+
+    /// The highest weight seen at each position, which unseen characters are predicted with.
+    std::vector<double> optimistic;
+
+    int generation = 0;
+
+    /// The best individual that has been truly evaluated, and its score.
+    std::string best;
+    double best_score = -std::numeric_limits<double>::infinity();
+
+    std::uint64_t evaluated = 0;
+    std::uint64_t skipped = 0;
+    std::uint64_t checked = 0;
+    double absolute_error = 0;
+
+    /// Buffers reused between generations.
+    std::vector<double> predictions;
+    std::vector<std::size_t> order;
+    Population candidates;
+    std::vector<double> candidate_scores;
+
+};
+
+#endif
@@ -0,0 +1,258 @@
+#include "threads.h"
+
+#include <algorithm>
+#include <fstream>
+#include <climits>
+#include <linux/futex.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "trace.h"
+
+
+namespace {
+
+    /// Parks the calling thread while a futex word still holds the expected value.
+    void futex_wait(std::atomic<std::uint32_t> &word, const std::uint32_t expected) {
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+    }
+
+    /// Wakes every thread parked on a futex word.
+    void futex_wake(std::atomic<std::uint32_t> &word) {
+        syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+    }
+
+    /// Tells the CPU that the calling thread is spinning, which frees resources for an SMT sibling.
+    void relax() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+
+    /// The current time, in nanoseconds since the epoch of the steady clock.
+    std::int64_t steady_now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+}
+
+
+Topology detect_topology() {
+
+    Topology topology;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+        topology.cpus.push_back(0);
+        topology.cores.push_back(0);
+        return topology;
+    }
+
+    std::vector<int> seen_cores;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+
+        if (!CPU_ISSET(cpu, &set)) {
+            continue;
+        }
+        topology.cpus.push_back(cpu);
+
+        // The siblings list starts with the lowest CPU of the core, which identifies it. If it is not available, every
+        // CPU is treated as its own core.
+        int core = cpu;
+        std::ifstream siblings("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/topology/thread_siblings_list");
+        siblings >> core;
+
+        if (std::find(seen_cores.begin(), seen_cores.end(), core) == seen_cores.end()) {
+            seen_cores.push_back(core);
+            topology.cores.push_back(cpu);
+        }
+
+    }
+
+    return topology;
+
+}
+
+
+std::size_t thread_limit(const Topology &topology) {
+    return topology.cpus.size() * THREADS_PER_CPU;
+}
+
+
+std::vector<int> place_threads(const Topology &topology, std::size_t threads, const bool physical) {
+
+    const std::vector<int> &candidates = physical ? topology.cores : topology.cpus;
+
+    if (threads == 0) {
+        threads = candidates.size();
+    }
+
+    std::vector<int> placement(threads);
+    for (std::size_t i = 0; i < threads; i++) {
+        placement[i] = candidates[i % candidates.size()];
+    }
+
+    return placement;
+
+}
+
+
+bool pin_thread(const int cpu) {
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+
+}
+
+
+std::string format_cpus(const std::vector<int> &cpus) {
+
+    std::string formatted;
+    for (const int cpu : cpus) {
+        formatted += (formatted.empty() ? "" : ",") + std::to_string(cpu);
+    }
+
+    return formatted;
+
+}
+
+
+SpinBarrier::SpinBarrier(const std::uint32_t parties, const std::uint32_t spins)
+        : parties(parties), spins(spins), remaining(parties) {}
+
+
+void SpinBarrier::arrive_and_wait(bool &sense) {
+
+    const TraceScope scope("barrier");
+
+    sense = !sense;
+    const std::uint32_t target = sense ? 1 : 0;
+
+    // The last thread to arrive resets the barrier for the next round, then flips the phase to release everyone.
+    if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+
+        remaining.store(parties, std::memory_order_relaxed);
+        phase.store(target);
+
+        if (sleepers.load() > 0) {
+            futex_wake(phase);
+        }
+        return;
+
+    }
+
+    for (std::uint32_t i = 0; i < spins; i++) {
+        if (phase.load(std::memory_order_acquire) == target) {
+            return;
+        }
+        relax();
+    }
+
+    // Registering as a sleeper before checking the phase again pairs with the releasing thread storing the phase
+    // before checking for sleepers, so a wake-up cannot be missed.
+    sleepers.fetch_add(1);
+    while (phase.load() != target) {
+        futex_wait(phase, 1 - target);
+    }
+    sleepers.fetch_sub(1);
+
+}
+
+
+// Spinning only helps if every worker has a CPU to itself, otherwise it delays the worker it is waiting on.
+WorkerPool::WorkerPool(const std::size_t workers, const std::vector<int> &cpus)
+        : barrier(static_cast<std::uint32_t>(workers),
+                  workers <= std::max(1U, std::thread::hardware_concurrency()) ? SPINS : 0),
+          busy_times(std::max<std::size_t>(workers, 1)) {
+
+    if (!cpus.empty()) {
+        pin_thread(cpus[0]);
+    }
+
+    for (std::size_t i = 1; i < workers; i++) {
+        threads.emplace_back(&WorkerPool::work, this, i, cpus.empty() ? -1 : cpus[i % cpus.size()]);
+    }
+
+}
+
+
+WorkerPool::~WorkerPool() {
+
+    if (threads.empty()) {
+        return;
+    }
+
+    // Release the workers from the barrier they are waiting at, with nothing to run.
+    stopping = true;
+    barrier.arrive_and_wait(sense);
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+}
+
+
+void WorkerPool::work(const std::size_t index, const int cpu) {
+
+    if (cpu >= 0) {
+        pin_thread(cpu);
+    }
+
+    trace_name_thread("worker " + std::to_string(index));
+
+    bool local_sense = false;
+
+    for (;;) {
+
+        // The barrier orders the calling thread's writes to the task before this thread reads them.
+        barrier.arrive_and_wait(local_sense);
+
+        if (stopping) {
+            return;
+        }
+
+        begin_task(index);
+        invoke(context, index);
+        end_task(index);
+        barrier.arrive_and_wait(local_sense);
+
+    }
+
+}
+
+
+void WorkerPool::start_busy(const std::size_t worker) {
+    busy_times[worker].since.store(steady_now(), std::memory_order_relaxed);
+}
+
+
+void WorkerPool::stop_busy(const std::size_t worker) {
+
+    BusyTime &time = busy_times[worker];
+    const std::int64_t since = time.since.load(std::memory_order_relaxed);
+    time.total.store(time.total.load(std::memory_order_relaxed) + steady_now() - since, std::memory_order_relaxed);
+    time.since.store(0, std::memory_order_relaxed);
+
+}
+
+
+std::chrono::nanoseconds WorkerPool::busy_time(const std::size_t worker) const {
+
+    // A reader may see a task that just finished both in the total and as still running, which only overstates the
+    // time for a moment.
+    const BusyTime &time = busy_times[worker];
+    const std::int64_t since = time.since.load(std::memory_order_relaxed);
+    const std::int64_t total = time.total.load(std::memory_order_relaxed);
+
+    return std::chrono::nanoseconds(total + (since != 0 ? steady_now() - since : 0));
+
+}
@@ -0,0 +1,233 @@
+#ifndef THREADS_H
+#define THREADS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+
+/**
+ * The CPUs that this process may run on.
+ */
+struct Topology {
+
+    /// The CPUs in the affinity mask of the process, which already excludes any CPU outside of its cgroup CPU set.
+    std::vector<int> cpus;
+
+    /// The first CPU of every physical core that has at least one CPU in {@link cpus}, skipping SMT siblings.
+    std::vector<int> cores;
+
+};
+
+/**
+ * Detects the CPUs that this process may run on, and how they are grouped into physical cores.
+ *
+ * @return The topology of the CPUs.
+ */
+Topology detect_topology();
+
+/// How many worker threads may share each CPU, beyond which more threads only add overhead.
+constexpr std::size_t THREADS_PER_CPU = 4;
+
+/**
+ * @param topology The topology of the CPUs.
+ *
+ * @return The most worker threads that a pool may be asked for, which is a small multiple of the available CPUs.
+ */
+std::size_t thread_limit(const Topology &topology);
+
+/**
+ * Chooses which CPU each worker thread should be pinned to.
+ *
+ * @param topology The topology of the CPUs.
+ * @param threads How many worker threads there are, or 0 for one per CPU (or per physical core).
+ * @param physical If only one thread should be placed on each physical core.
+ *
+ * @return The CPU of each worker thread. CPUs are reused if there are more threads than CPUs.
+ */
+std::vector<int> place_threads(const Topology &topology, std::size_t threads, bool physical);
+
+/**
+ * Pins the calling thread to a single CPU.
+ *
+ * @param cpu The CPU to pin to.
+ *
+ * @return If the thread was pinned.
+ */
+bool pin_thread(int cpu);
+
+/**
+ * Formats a list of CPUs, such as "0,2,4,6".
+ */
+std::string format_cpus(const std::vector<int> &cpus);
+
+
+/**
+ * A sense-reversing barrier which spins for a short while before parking the waiting threads on a futex. A generation
+ * of a small population only takes a few microseconds, which is far less than the cost of putting a thread to sleep
+ * and waking it, so waiting threads spin first and only park once it is clear the wait will be long.
+ */
+class SpinBarrier {
+
+public:
+
+    /**
+     * @param parties How many threads wait at the barrier.
+     * @param spins How many times to check the barrier before parking, where 0 parks straight away.
+     */
+    SpinBarrier(std::uint32_t parties, std::uint32_t spins);
+
+    /**
+     * Waits until every party has arrived at the barrier.
+     *
+     * @param sense The sense of the calling thread, which must start as false and is only used by that thread.
+     */
+    void arrive_and_wait(bool &sense);
+
+private:
+
+    const std::uint32_t parties;
+    const std::uint32_t spins;
+
+    /// Each counter lives on its own cache line, as every arrival writes to one and every waiter polls the other.
+    alignas(64) std::atomic<std::uint32_t> remaining;
+    alignas(64) std::atomic<std::uint32_t> phase{0};
+    alignas(64) std::atomic<std::uint32_t> sleepers{0};
+
+};
+
+
+/**
+ * A fixed set of worker threads which each run a part of a task. The thread that calls {@link run} takes part as
+ * worker 0, so a pool of one worker runs everything on the calling thread.
+ *
+ * Workers can be pinned to CPUs, so that each one keeps the same slice of the population warm in its own caches
+ * between generations.
+ */
+class WorkerPool {
+
+public:
+
+    /**
+     * @param workers How many workers there are, including the calling thread.
+     * @param cpus The CPU to pin each worker to, or an empty list to leave them unpinned.
+     */
+    WorkerPool(std::size_t workers, const std::vector<int> &cpus);
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+    ~WorkerPool();
+
+    /**
+     * @return How many workers there are, including the calling thread.
+     */
+    [[nodiscard]] std::size_t size() const {
+        return threads.size() + 1;
+    }
+
+    /// How many times a waiting worker checks the barrier before parking.
+    static constexpr std::uint32_t SPINS = 20000;
+
+    /**
+     * Starts measuring how long each worker spends running tasks, which costs two clock reads per worker per task. It
+     * must not be called while a task is running.
+     */
+    void measure_busy_time() {
+        measuring = true;
+    }
+
+    /**
+     * Reads how long a worker has spent running tasks since measuring started, including the task it is running now.
+     * It may be called from any thread.
+     *
+     * @param worker The index of the worker.
+     *
+     * @return The time spent running tasks.
+     */
+    [[nodiscard]] std::chrono::nanoseconds busy_time(std::size_t worker) const;
+
+    /**
+     * Runs a task on every worker, and waits for all of them to finish. The task is handed over by reference, so
+     * nothing is allocated per call.
+     *
+     * @param task The task, which is given the index of the worker running it.
+     */
+    template<typename Task>
+    void run(Task &&task) {
+
+        if (threads.empty()) {
+            begin_task(0);
+            task(std::size_t{0});
+            end_task(0);
+            return;
+        }
+
+        context = &task;
+        invoke = [](void *context, const std::size_t worker) {
+            (*static_cast<std::remove_reference_t<Task> *>(context))(worker);
+        };
+
+        // The first barrier publishes the task, and the second waits for every worker to finish it.
+        barrier.arrive_and_wait(sense);
+        begin_task(0);
+        task(std::size_t{0});
+        end_task(0);
+        barrier.arrive_and_wait(sense);
+
+    }
+
+private:
+
+    /// The time a worker has spent running tasks, on its own cache line as only that worker writes to it.
+    struct alignas(64) BusyTime {
+
+        /// The time spent in tasks that have finished, in nanoseconds.
+        std::atomic<std::int64_t> total{0};
+
+        /// When the running task started, in nanoseconds since the clock's epoch, or 0 if none is running.
+        std::atomic<std::int64_t> since{0};
+
+    };
+
+    /// Marks the start of a task on a worker, if busy time is being measured.
+    void begin_task(const std::size_t worker) {
+        if (measuring) {
+            start_busy(worker);
+        }
+    }
+
+    /// Marks the end of a task on a worker, if busy time is being measured.
+    void end_task(const std::size_t worker) {
+        if (measuring) {
+            stop_busy(worker);
+        }
+    }
+
+    void start_busy(std::size_t worker);
+    void stop_busy(std::size_t worker);
+
+    /// The loop of each background worker.
+    void work(std::size_t index, int cpu);
+
+    std::vector<std::thread> threads;
+    SpinBarrier barrier;
+
+    /// The sense of the calling thread at the barrier.
+    bool sense = false;
+
+    /// The task being run, which is only written by the calling thread between generations.
+    void *context = nullptr;
+    void (*invoke)(void *, std::size_t) = nullptr;
+    bool stopping = false;
+
+    /// If busy time is measured, and the busy time of each worker.
+    bool measuring = false;
+    std::vector<BusyTime> busy_times;
+
+};
+
+#endif
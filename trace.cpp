@@ -0,0 +1,155 @@
+#include "trace.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+
+std::atomic<bool> tracing{false};
+
+
+namespace {
+
+    /// A single recorded event.
+    struct TraceEvent {
+        const char *name;
+        std::int64_t start;
+        std::int64_t end;
+    };
+
+    /// How many events each chunk of a buffer holds.
+    constexpr std::size_t CHUNK_EVENTS = 4096;
+
+    /// The events recorded by a single thread, which only that thread writes to. Chunks are allocated as the events
+    /// arrive, so that threads which record few events hold little memory.
+    struct TraceBuffer {
+        std::string thread_name;
+        std::vector<std::unique_ptr<TraceEvent[]>> chunks;
+        std::atomic<std::size_t> count{0};
+        std::uint64_t dropped = 0;
+
+        [[nodiscard]] const TraceEvent &operator[](const std::size_t index) const {
+            return chunks[index / CHUNK_EVENTS][index % CHUNK_EVENTS];
+        }
+    };
+
+    std::chrono::steady_clock::time_point epoch;
+    std::size_t buffer_capacity = 0;
+
+    /// Every thread's buffer, which is only locked when a thread records its first event.
+    std::mutex registry_mutex;
+    std::vector<std::unique_ptr<TraceBuffer>> registry;
+
+    thread_local TraceBuffer *buffer = nullptr;
+    thread_local std::string thread_name;
+
+    /// Writes a string as a JSON string literal.
+    void write_json_string(std::ostream &out, const std::string &value) {
+        out << '"';
+        for (const char c : value) {
+            if (c == '"' || c == '\\') {
+                out << '\\';
+            }
+            out << c;
+        }
+        out << '"';
+    }
+
+}
+
+
+void trace_enable(const std::size_t capacity) {
+    epoch = std::chrono::steady_clock::now();
+    buffer_capacity = capacity;
+    tracing.store(true);
+}
+
+
+void trace_name_thread(const std::string &name) {
+    thread_name = name;
+}
+
+
+std::int64_t trace_now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+
+void trace_record(const char *name, const std::int64_t start, const std::int64_t end) {
+
+    // The buffer is registered on the first event, which is the only time that recording takes a lock.
+    if (buffer == nullptr) {
+
+        auto created = std::make_unique<TraceBuffer>();
+        created->thread_name = thread_name;
+
+        std::lock_guard lock(registry_mutex);
+        buffer = created.get();
+        registry.push_back(std::move(created));
+
+    }
+
+    const std::size_t count = buffer->count.load(std::memory_order_relaxed);
+    if (count == buffer_capacity) {
+        buffer->dropped++;
+        return;
+    }
+
+    // Allocate the next chunk once the last one is full, which is only every few thousand events.
+    if (count % CHUNK_EVENTS == 0) {
+        buffer->chunks.push_back(std::make_unique<TraceEvent[]>(CHUNK_EVENTS));
+    }
+
+    buffer->chunks.back()[count % CHUNK_EVENTS] = {name, start, end};
+    buffer->count.store(count + 1, std::memory_order_release);
+
+}
+
+
+std::string trace_write(const std::string &path) {
+
+    std::ofstream out(path, std::ios::trunc);
+    if (!out) {
+        return path + ": " + std::strerror(errno);
+    }
+
+    std::lock_guard lock(registry_mutex);
+
+    out << std::fixed << std::setprecision(3) << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+
+    bool first = true;
+    for (std::size_t tid = 0; tid < registry.size(); tid++) {
+
+        const TraceBuffer &thread = *registry[tid];
+
+        out << (first ? "" : ",\n") << R"({"name":"thread_name","ph":"M","pid":1,"tid":)" << tid
+            << R"(,"args":{"name":)";
+        write_json_string(out, thread.thread_name.empty() ? "thread " + std::to_string(tid) : thread.thread_name);
+        out << "}}";
+        first = false;
+
+        // Timestamps are in microseconds, so nanoseconds are kept as fractions.
+        const std::size_t count = thread.count.load(std::memory_order_acquire);
+        for (std::size_t i = 0; i < count; i++) {
+            const TraceEvent &event = thread[i];
+            out << ",\n" << R"({"name":")" << event.name << R"(","ph":"X","pid":1,"tid":)" << tid
+                << ",\"ts\":" << static_cast<double>(event.start) / 1000
+                << ",\"dur\":" << static_cast<double>(event.end - event.start) / 1000 << '}';
+        }
+
+        if (thread.dropped > 0) {
+            out << ",\n" << R"({"name":"dropped events","ph":"i","s":"t","pid":1,"tid":)" << tid << ",\"ts\":0"
+                << R"(,"args":{"count":)" << thread.dropped << "}}";
+        }
+
+    }
+
+    out << "\n]}\n";
+
+    return out ? "" : path + ": failed to write";
+
+}
@@ -0,0 +1,95 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+
+/**
+ * An opt-in tracer which records how long each phase of each generation took on each thread, and writes them out as
+ * Chrome trace events which can be opened in chrome://tracing or the Perfetto UI.
+ *
+ * Every thread records into its own buffer, which grows in chunks up to a fixed capacity, so recording never takes a
+ * lock and threads that record little hold little memory. When tracing is disabled, a {@link TraceScope} costs a single
+ * relaxed load.
+ */
+
+/// If events are being recorded.
+extern std::atomic<bool> tracing;
+
+/**
+ * Starts recording events.
+ *
+ * @param capacity How many events each thread can record. Events beyond this are dropped and counted.
+ */
+void trace_enable(std::size_t capacity);
+
+/**
+ * Names the calling thread in the trace.
+ *
+ * @param name The name of the thread.
+ */
+void trace_name_thread(const std::string &name);
+
+/**
+ * Records a single event on the calling thread.
+ *
+ * @param name The name of the event, which must outlive the tracer.
+ * @param start When the event started, in nanoseconds since tracing was enabled.
+ * @param end When the event ended, in nanoseconds since tracing was enabled.
+ */
+void trace_record(const char *name, std::int64_t start, std::int64_t end);
+
+/**
+ * @return The current time, in nanoseconds since tracing was enabled.
+ */
+std::int64_t trace_now();
+
+/**
+ * Writes every recorded event to a file in the Chrome trace event format. The threads that recorded them must not be
+ * recording anymore.
+ *
+ * @param path The path of the file.
+ *
+ * @return An empty string if the file was written, otherwise a description of the error.
+ */
+std::string trace_write(const std::string &path);
+
+
+/**
+ * Records an event covering the lifetime of the scope.
+ */
+class TraceScope {
+
+public:
+
+    /**
+     * @param name The name of the event, which must outlive the tracer.
+     */
+    explicit TraceScope(const char *name) : name(name) {
+        if (tracing.load(std::memory_order_relaxed)) {
+            start = trace_now();
+        }
+    }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+    ~TraceScope() {
+        if (start >= 0) {
+            trace_record(name, start, trace_now());
+        }
+    }
+
+private:
+
+    const char *name;
+
+    /// When the scope started, or -1 if tracing was disabled at the time.
+    std::int64_t start = -1;
+
+};
+
+#endif
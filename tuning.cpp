@@ -0,0 +1,146 @@
+#include "tuning.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+#include "population.h"
+#include "threads.h"
+
+
+namespace {
+
+    /// The outcome of a single run.
+    struct Run {
+        std::size_t candidate;
+        std::size_t instance;
+        double cost = 0;
+        double seconds = 0;
+        bool solved = false;
+    };
+
+    /**
+     * Runs a single evolution on the calling thread. Every candidate runs the same instance against the same target,
+     * starting from the same individual with the same seed, so that candidates are compared on equal terms.
+     */
+    void execute(Run &run, const TuningCandidate &candidate, const std::vector<std::string> &targets,
+                 const RaceSettings &settings) {
+
+        const std::string &target = targets[run.instance % targets.size()];
+        Population population(candidate.population, target.length());
+        WorkerPool pool(1, {});
+
+        const std::string start = starting_individual(target.length(), run.instance);
+
+        EvolutionSettings evolution_settings{target, candidate.mutation_chance, settings.fitness_mode, settings.sparse};
+        Evolution evolution(evolution_settings, population, pool, nullptr, run.instance);
+        evolution.reset(start);
+
+        const auto begin = std::chrono::steady_clock::now();
+        Evolution::Generation result{};
+        std::uint64_t evaluations = 0;
+        do {
+            result = evolution.step();
+            evaluations += candidate.population;
+        } while (!result.solved && evaluations < settings.max_evaluations);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+        run.solved = result.solved;
+        run.cost = result.solved
+                   ? static_cast<double>(evaluations)
+                   : UNSOLVED_PENALTY * static_cast<double>(settings.max_evaluations);
+        run.seconds = elapsed.count();
+
+    }
+
+}
+
+
+std::vector<TuningCandidate> tuning_grid(const std::vector<std::size_t> &populations,
+                                         const std::vector<double> &mutation_chances) {
+
+    std::vector<TuningCandidate> candidates;
+    for (const std::size_t population : populations) {
+        for (const double mutation_chance : mutation_chances) {
+            candidates.push_back({population, mutation_chance});
+        }
+    }
+
+    return candidates;
+
+}
+
+
+std::vector<TuningResult> race(const std::vector<TuningCandidate> &candidates, const std::vector<std::string> &targets,
+                               const RaceSettings &settings) {
+
+    std::vector<TuningResult> results(candidates.size());
+    std::vector<std::size_t> alive(candidates.size());
+    for (std::size_t i = 0; i < candidates.size(); i++) {
+        results[i].candidate = candidates[i];
+        alive[i] = i;
+    }
+
+    // The pool runs whole evolutions, each of which runs serially on whichever worker claimed it.
+    WorkerPool racers(std::max<std::size_t>(settings.threads, 1), {});
+
+    std::size_t instances = 0;
+    std::size_t round_runs = std::max(settings.initial_runs, 1);
+
+    for (int round = 1;; round++) {
+
+        // Every surviving candidate runs the next instances, which none of them have run before.
+        std::vector<Run> runs;
+        for (const std::size_t candidate : alive) {
+            for (std::size_t instance = instances; instance < instances + round_runs; instance++) {
+                runs.push_back({candidate, instance});
+            }
+        }
+
+        std::atomic<std::size_t> next = 0;
+        racers.run([&](std::size_t) {
+            for (std::size_t i = next.fetch_add(1); i < runs.size(); i = next.fetch_add(1)) {
+                execute(runs[i], candidates[runs[i].candidate], targets, settings);
+            }
+        });
+
+        for (const Run &run : runs) {
+            TuningResult &result = results[run.candidate];
+            result.runs++;
+            result.solved += run.solved;
+            result.cost += run.cost;
+            result.seconds += run.seconds;
+        }
+
+        instances += round_runs;
+        round_runs = instances;
+
+        // Ties are broken by the time taken, so that the quicker of two equally costly candidates survives.
+        std::stable_sort(alive.begin(), alive.end(), [&](const std::size_t a, const std::size_t b) {
+            const double a_cost = results[a].mean_cost();
+            const double b_cost = results[b].mean_cost();
+            return a_cost < b_cost || (a_cost == b_cost && results[a].seconds < results[b].seconds);
+        });
+
+        for (std::size_t i = (alive.size() + 1) / 2; i < alive.size(); i++) {
+            results[alive[i]].eliminated = round;
+        }
+        alive.resize((alive.size() + 1) / 2);
+
+        if (alive.size() <= 1) {
+            break;
+        }
+
+    }
+
+    // The winner comes first, followed by the rest from the last eliminated to the first, best first within a round.
+    std::stable_sort(results.begin(), results.end(), [](const TuningResult &a, const TuningResult &b) {
+        if (a.eliminated != b.eliminated) {
+            return a.eliminated == 0 || (b.eliminated != 0 && a.eliminated > b.eliminated);
+        }
+        return a.mean_cost() < b.mean_cost();
+    });
+
+    return results;
+
+}
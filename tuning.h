@@ -0,0 +1,110 @@
+#ifndef TUNING_H
+#define TUNING_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "engine.h"
+
+
+/// The penalty that a run which did not reach its target is scored with, as a multiple of the evaluations it was given.
+static constexpr double UNSOLVED_PENALTY = 2;
+
+/**
+ * A configuration of the hyperparameters that drive the time to reach a target.
+ */
+struct TuningCandidate {
+
+    /// How many individuals the population is comprised of.
+    std::size_t population = 100;
+
+    /// The chance for each value to mutate.
+    double mutation_chance = 0.01;
+
+};
+
+/**
+ * The totals of every run of a single candidate during a race.
+ */
+struct TuningResult {
+
+    /// The candidate that was run.
+    TuningCandidate candidate;
+
+    /// How many evolutions were run, and how many of them reached their target.
+    int runs = 0;
+    int solved = 0;
+
+    /// The evaluations taken to reach the target over every run, where runs that did not reach it are penalized.
+    double cost = 0;
+
+    /// The time taken by every run, in seconds.
+    double seconds = 0;
+
+    /// The round in which the candidate was eliminated, or 0 if it won the race.
+    int eliminated = 0;
+
+    /**
+     * @return The average evaluations taken to reach the target, which candidates are ranked by.
+     */
+    [[nodiscard]] double mean_cost() const {
+        return runs > 0 ? cost / runs : 0;
+    }
+
+};
+
+/**
+ * The settings of a race.
+ */
+struct RaceSettings {
+
+    /// How many runs each candidate is given in the first round. The runs given double every round after it.
+    int initial_runs = 2;
+
+    /// How many runs are executed at once, each on its own thread.
+    std::size_t threads = 1;
+
+    /// The most evaluations a single run may take before it is stopped and penalized.
+    std::uint64_t max_evaluations = 1000000;
+
+    /// The mode used to score individuals.
+    FitnessMode fitness_mode = FitnessMode::EXACT;
+
+    /// If mutation skips straight to the characters that mutate, using {@link mutate_sparse}.
+    bool sparse = false;
+
+};
+
+
+/**
+ * Builds every combination of population sizes and mutation chances.
+ *
+ * @param populations The population sizes to try.
+ * @param mutation_chances The mutation chances to try.
+ *
+ * @return The candidates.
+ */
+std::vector<TuningCandidate> tuning_grid(const std::vector<std::size_t> &populations,
+                                         const std::vector<double> &mutation_chances);
+
+/**
+ * Races candidates against each other by successive halving. Every round runs each surviving candidate against the
+ * same targets with the same seeds, ranks the candidates by the average evaluations they took to reach their target,
+ * and eliminates the worse half, until a single candidate remains. Runs from every round are executed in parallel,
+ * so a round takes as long as its slowest runs rather than all of them.
+ *
+ * Candidates are ranked by evaluations rather than time, as the time of runs that share the CPUs depends on what else
+ * is running alongside them.
+ *
+ * @param candidates The candidates to race, which must not be empty.
+ * @param targets The targets to run against, which are cycled through by each candidate's runs.
+ * @param settings The settings of the race.
+ *
+ * @return The result of every candidate, starting with the winner and followed by the rest in the order they were
+ *         eliminated, from last to first.
+ */
+std::vector<TuningResult> race(const std::vector<TuningCandidate> &candidates, const std::vector<std::string> &targets,
+                               const RaceSettings &settings);
+
+#endif
@@ -0,0 +1,177 @@
+#include "workload.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "random.h"
+
+
+namespace {
+
+    /// The printable characters in the order they join the alphabet, so that an alphabet of 4 is a genome's bases.
+    constexpr std::string_view ALPHABET = "ACGTBDEFHIJKLMNOPQRSUVWXYZ abcdefghijklmnopqrstuvwxyz0123456789.,;:!?'\"-()"
+                                          "[]{}<>/\\|@#$%^&*_+=`~";
+
+    static_assert(ALPHABET.length() == 95, "Every printable character must be in the alphabet exactly once");
+
+    /**
+     * Builds the probability of each character of an alphabet, following a Zipf distribution with a given exponent.
+     */
+    std::vector<double> zipf(const std::size_t alphabet, const double exponent) {
+
+        std::vector<double> weights(alphabet);
+        double total = 0;
+        for (std::size_t i = 0; i < alphabet; i++) {
+            weights[i] = 1.0 / std::pow(static_cast<double>(i + 1), exponent);
+            total += weights[i];
+        }
+        for (double &weight : weights) {
+            weight /= total;
+        }
+
+        return weights;
+
+    }
+
+    /**
+     * Calculates the entropy of a distribution in bits.
+     */
+    double entropy(const std::vector<double> &probabilities) {
+        double bits = 0;
+        for (const double probability : probabilities) {
+            bits -= probability > 0 ? probability * std::log2(probability) : 0;
+        }
+        return bits;
+    }
+
+    /**
+     * Finds the distribution over an alphabet with a given entropy, by searching for the Zipf exponent that reaches
+     * it. Entropy falls as the exponent grows, so a bisection converges on it.
+     */
+    std::vector<double> distribution(const std::size_t alphabet, const double bits) {
+
+        double low = 0;
+        double high = 64;
+        for (int i = 0; i < 64; i++) {
+            const double middle = (low + high) / 2;
+            (entropy(zipf(alphabet, middle)) > bits ? low : high) = middle;
+        }
+
+        return zipf(alphabet, (low + high) / 2);
+
+    }
+
+    /**
+     * Draws a character from a cumulative distribution.
+     */
+    char draw(const std::vector<double> &cumulative, Random &random) {
+        const double point = random.chance();
+        const auto index = std::upper_bound(cumulative.begin(), cumulative.end(), point) - cumulative.begin();
+        return ALPHABET[std::min(static_cast<std::size_t>(index), cumulative.size() - 1)];
+    }
+
+}
+
+
+const std::vector<WorkloadProfile> &workload_profiles() {
+
+    static const std::vector<WorkloadProfile> profiles = {
+
+            // Many short, similar English-like strings, as produced by a batch of text jobs.
+            {"short-text", 32, 16, 64, 64, 4.2, 0.25, 100},
+
+            // A few long strings over a genome's four bases.
+            {"long-genome", 4, 4096, 8192, 4, 1.9, 0.5, 100},
+
+            // Target lengths like the default target, evolved by a very large population.
+            {"huge-population", 4, 41, 41, 95, 6.5, 0, 100000}
+
+    };
+
+    return profiles;
+
+}
+
+
+const WorkloadProfile *find_workload(const std::string &name) {
+
+    const auto &profiles = workload_profiles();
+    const auto found = std::find_if(profiles.begin(), profiles.end(), [&](const WorkloadProfile &profile) {
+        return profile.name == name;
+    });
+
+    return found == profiles.end() ? nullptr : &*found;
+
+}
+
+
+std::vector<std::string> generate_targets(const WorkloadProfile &profile) {
+
+    const std::size_t alphabet = std::clamp<std::size_t>(profile.alphabet, 1, ALPHABET.length());
+    const std::vector<double> probabilities = distribution(alphabet, profile.entropy);
+
+    std::vector<double> cumulative(alphabet);
+    double total = 0;
+    for (std::size_t i = 0; i < alphabet; i++) {
+        total += probabilities[i];
+        cumulative[i] = total;
+    }
+
+    Random random(profile.seed);
+
+    // The base target which every target shares a fraction of its positions with.
+    std::string base(profile.max_length, ' ');
+    for (char &c : base) {
+        c = draw(cumulative, random);
+    }
+
+    std::vector<std::string> targets(profile.targets);
+    for (std::string &target : targets) {
+
+        const auto span = static_cast<std::uint32_t>(profile.max_length - profile.min_length + 1);
+        target.resize(profile.min_length + random.below(span));
+
+        for (std::size_t i = 0; i < target.length(); i++) {
+            target[i] = random.chance() < profile.similarity ? base[i] : draw(cumulative, random);
+        }
+
+    }
+
+    return targets;
+
+}
+
+
+double measure_entropy(const std::vector<std::string> &targets) {
+
+    std::array<double, 256> counts{};
+    double total = 0;
+    for (const std::string &target : targets) {
+        for (const char c : target) {
+            counts[static_cast<unsigned char>(c)]++;
+            total++;
+        }
+    }
+
+    std::vector<double> probabilities;
+    for (const double count : counts) {
+        probabilities.push_back(count / total);
+    }
+
+    return entropy(probabilities);
+
+}
+
+
+double measure_similarity(const std::string_view a, const std::string_view b) {
+
+    const std::size_t length = std::min(a.length(), b.length());
+    std::size_t same = 0;
+    for (std::size_t i = 0; i < length; i++) {
+        same += a[i] == b[i];
+    }
+
+    return length == 0 ? 1 : static_cast<double>(same) / static_cast<double>(length);
+
+}
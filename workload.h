@@ -0,0 +1,87 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+/// The version of the generator. It is bumped whenever the same profile would generate different targets, so that
+/// benchmark results are only compared when they were run against the same workloads.
+static constexpr int WORKLOAD_VERSION = 1;
+
+/**
+ * Describes a set of synthetic targets, and the population size they are meant to be evolved with.
+ */
+struct WorkloadProfile {
+
+    /// The name of the profile.
+    std::string name;
+
+    /// How many targets are in the set.
+    std::size_t targets = 1;
+
+    /// The range of target lengths, which are drawn uniformly. The minimum is at least 1, and not above the maximum.
+    std::size_t min_length = 41;
+    std::size_t max_length = 41;
+
+    /// How many distinct characters the targets are drawn from, up to 95 printable characters.
+    std::size_t alphabet = 95;
+
+    /// The Shannon entropy of the characters in bits, up to log2 of the alphabet, which is reached by drawing every
+    /// character uniformly. Lower entropies skew the draws towards the start of the alphabet.
+    double entropy = 6.569855608330948;
+
+    /// The fraction of positions every target shares with a common base target, within [0, 1].
+    double similarity = 0;
+
+    /// How many individuals a population should be comprised of.
+    std::size_t population = 100;
+
+    /// The seed of the generator.
+    std::uint64_t seed = 1944;
+
+};
+
+/**
+ * @return The canned profiles: 'short-text', 'long-genome' and 'huge-population'.
+ */
+const std::vector<WorkloadProfile> &workload_profiles();
+
+/**
+ * Finds a canned profile by its name.
+ *
+ * @param name The name of the profile.
+ *
+ * @return The profile, or nullptr if there is none with that name.
+ */
+const WorkloadProfile *find_workload(const std::string &name);
+
+/**
+ * Generates the targets of a profile. The same profile always generates the same targets for the same {@link
+ * WORKLOAD_VERSION}, on any platform.
+ *
+ * @param profile The profile.
+ *
+ * @return The targets.
+ */
+std::vector<std::string> generate_targets(const WorkloadProfile &profile);
+
+/**
+ * Measures the Shannon entropy of the characters of some targets.
+ *
+ * @param targets The targets.
+ *
+ * @return The entropy in bits per character.
+ */
+double measure_entropy(const std::vector<std::string> &targets);
+
+/**
+ * Measures how similar two targets are.
+ *
+ * @return The fraction of positions within the shorter target where both targets have the same character.
+ */
+double measure_similarity(std::string_view a, std::string_view b);
+
+#endif